@@ -125,7 +125,7 @@ bool Application::init(int argc, const char* argv[]) {
 		setNumber("logs.rotation", rotation);
 		setNumber("logs.maxSize", sizeByFile);
 		// Set Logger after opening _logStream!
-		if (!Logs::AddLogger<FileLogger>(String("file!", name(), " already running?"), move(logDir), sizeByFile, rotation))
+		if (!Logs::AddLogger<FileLogger>(String("file!", name(), " already running?"), move(logDir), sizeByFile, rotation, get<bool>("logs.binary", false), get<bool>("logs.mapped", false)))
 			FATAL_ERROR(name(), " initLogs can't override file logger");
 	}
 
@@ -251,12 +251,14 @@ void Application::onParamChange(const string& key, const string* pValue) {
 		if (pValue)
 			String::toNumber(*pValue, level);
 		Logs::SetLevel(level);
-	}
+	} else if (String::ICompare(key, "logs.async") == 0)
+		Logs::SetAsync(pValue && String::IsTrue(*pValue));
 		
 	Parameters::onParamChange(key, pValue);
 }
 void Application::onParamClear() {
 	Logs::SetLevel(get<uint8_t>("arguments.log", LOG_DEFAULT));
+	Logs::SetAsync(false);
 	Net::ResetRecvBufferSize();
 	Net::ResetSendBufferSize();
 	Parameters::onParamClear();
@@ -15,6 +15,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/Disk/IOFile.h"
+#include "Mona/Net/Socket.h"
 #include <list>
 
 using namespace std;
@@ -88,10 +89,14 @@ private:
 };
 
 IOFile::IOFile(const Handler& handler, const ThreadPool& threadPool, uint16_t cores) :
-	handler(handler), threadPool(threadPool), _threadPool(Thread::PRIORITY_LOW, cores*2) { // 2*CPU => because disk speed can be at maximum 2x more than memory, and Low priority to not impact main thread pool
+	handler(handler), threadPool(threadPool), _threadPool(Thread::PRIORITY_LOW, cores*2), _pSelf(SET, self) { // 2*CPU => because disk speed can be at maximum 2x more than memory, and Low priority to not impact main thread pool
 }
 
 IOFile::~IOFile() {
+	{ // no more sending resumed by a socket flush
+		lock_guard<mutex> lock(_pSelf->mutex);
+		_pSelf->pIOFile = NULL;
+	}
 	join();
 	stop(); // file watchers!
 }
@@ -207,6 +212,86 @@ void IOFile::write(const Shared<File>& pFile, const Packet& packet) {
 		_threadPool.queue<WriteFile>(pFile->_ioTrack, handler, pFile, packet);
 }
 
+void IOFile::send(const Shared<File>& pFile, const Shared<Socket>& pSocket, uint64_t size) {
+	struct SendFile : WAction {
+		SendFile(const Shared<Self>& pSelf, const Handler& handler, const Shared<File>& pFile, const Shared<Socket>& pSocket, uint64_t size, const Exception& ex = nullptr) :
+			WAction("SendFile", handler, pFile), _pSelf(pSelf), _pSocket(pSocket), _size(size), _ex(ex) {}
+	private:
+		enum {
+			QUEUEING_MAX = 0x40000 // bytes queued in socket before to wait its flush (backpressure)
+		};
+		struct Handle : Action::Handle, virtual Object {
+			Handle(const char* name, const Shared<File>& pFile) : Action::Handle(name, pFile) {}
+		private:
+			void handle(File& file) { file._onFlush(false); }
+		};
+		bool process(Exception& ex, const Shared<File>& pFile) {
+			if (_ex) { // socket flush has failed
+				ex = move(_ex);
+				return false;
+			}
+			if (!pFile->load(ex))
+				return false;
+			if (pFile->mode) {
+				ex.set<Ex::Permission>(pFile->path(), " read unauthorized in writing, append or deletion mode");
+				return false;
+			}
+			// use pFile->size() without refreshing to use as same size as caller has gotten it (for example to write a content-length in header)
+			uint64_t size = min(pFile->size() - pFile->readen(), _size);
+			// sending stops while socket queues too much and resumes on its flush with a new sending of the rest,
+			// so File::OnFlush is raised once all has been transmitted with a socket queue under QUEUEING_MAX
+			while (size || _pSocket->queueing() > QUEUEING_MAX) {
+				if (_pSocket->queueing() > QUEUEING_MAX) {
+					// weak socket because socket keeps this callback, and _pSelf rather IOFile& which can die before
+					Shared<Self> pSelf(_pSelf);
+					Weak<Socket> weakSocket(_pSocket);
+					_pSocket->waitFlush(QUEUEING_MAX, [pSelf, pFile, weakSocket, size](const Exception& ex) {
+						lock_guard<mutex> lock(pSelf->mutex);
+						if (!pSelf->pIOFile)
+							return; // IOFile deleted
+						Shared<Socket> pSocket(weakSocket.lock());
+						Exception error(ex);
+						if (!pSocket && !error)
+							error.set<Ex::Net::Socket>("Socket deleted before end of file sending");
+						pSelf->pIOFile->_threadPool.queue<SendFile>(pFile->_ioTrack, pSelf, pSelf->pIOFile->handler, pFile, pSocket, size, error);
+					});
+					return true;
+				}
+#if defined(__linux__)
+				if (_pSocket->type == Socket::TYPE_STREAM && !_pSocket->isEncrypting()) {
+					// zero-copy by steps, socket keeps the file alive while region is queued
+					uint64_t step(min<uint64_t>(size, QUEUEING_MAX));
+					if (_pSocket->write(ex, int(pFile->_handle), pFile->readen(), step, pFile) < 0)
+						return false;
+					lseek64(pFile->_handle, step, SEEK_CUR);
+					pFile->_readen += step;
+					size -= step;
+					continue;
+				}
+#endif
+				// copy
+				Shared<Buffer> pBuffer(SET, uint32_t(min<uint64_t>(size, 0xFFFFu)));
+				int readen = pFile->read(ex, pBuffer->data(), pBuffer->size());
+				if (readen < 0)
+					return false;
+				if (!readen)
+					break; // file truncated
+				pBuffer->resize(readen);
+				if (_pSocket->write(ex, Packet(pBuffer)) < 0)
+					return false;
+				size -= readen;
+			}
+			handle<Handle>(pFile);
+			return true;
+		}
+		Shared<Self>	_pSelf;
+		Shared<Socket>	_pSocket;
+		uint64_t		_size;
+		Exception		_ex;
+	};
+	_threadPool.queue<SendFile>(pFile->_ioTrack, _pSelf, handler, pFile, pSocket, size);
+}
+
 void IOFile::erase(const Shared<File>& pFile) {
 	struct EraseFile : SAction { // SAction to allow file writing full asynchronous (without any other hand on the file)
 		EraseFile(const Handler& handler, const Shared<File>& pFile) : SAction("EraseFile", handler, pFile) {}
@@ -25,6 +25,8 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 namespace Mona {
 
+struct Socket;
+
 /*!
 IOFile performs asynchrone writing and reading operation,
 It uses a Thread::ProcessorCount() threads with low priority to load/read/write files
@@ -76,6 +78,14 @@ struct IOFile : virtual Object, Thread { // Thread is for file watching!
 	Async write with file load if file not loaded */
 	void write(const Shared<File>& pFile, const Packet& packet);
 	/*!
+	Async sending of file content to a socket with file load if file not loaded,
+	zero-copy (sendfile) with a plain or kernel TLS offloaded stream socket on Linux, otherwise file is readen and copied to the socket,
+	data not sendable immediatly are queued in the socket (socket queueing() and onFlush backpressure),
+	the sending is suspended while the socket queues more than 256KB and resumes on socket flush (File::OnError if socket fails),
+	File::OnFlush(false) is raised when size requested has been transmitted to the socket (readen() gives the progression)
+	size default = file size remaining */
+	void send(const Shared<File>& pFile, const Shared<Socket>& pSocket, uint64_t size = -1);
+	/*!
 	Async file/folder deletion*/
 	void erase(const Shared<File>& pFile);
 	/*!
@@ -93,11 +103,19 @@ private:
 	struct Action;
 	struct WAction;
 	struct SAction;
+	/*!
+	Kept by a sending waiting a socket flush rather than IOFile which can be deleted before */
+	struct Self : virtual Object {
+		Self(IOFile& io) : pIOFile(&io) {}
+		std::mutex	mutex;
+		IOFile*		pIOFile; // null on IOFile deletion
+	};
 
 
 	ThreadPool								_threadPool; // Pool of threads for writing/reading disk operation
 	std::vector<Shared<const FileWatcher>>	_watchers;
 	std::mutex								_mutexWatchers;
+	Shared<Self>							_pSelf;
 };
 
 
@@ -58,6 +58,7 @@ struct BinaryReader : Bytes, virtual Object {
 
 	const char*		current() const { return _current; }
 	uint32_t		available() const { return _end-_current; }
+	Bytes::Order	byteOrder() const { return _flipBytes ? (ORDER_NATIVE == ORDER_BIG_ENDIAN ? ORDER_LITTLE_ENDIAN : ORDER_BIG_ENDIAN) : ORDER_NATIVE; }
 
 	// beware, data() can be null
 	const char*		data() const override { return _data; }
@@ -0,0 +1,399 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Format/Codec.h"
+#include "Mona/Util/CPU.h"
+#if defined(_X86)
+	#include <immintrin.h>
+#elif defined(_ARM64)
+	#include <arm_neon.h>
+#endif
+
+using namespace std;
+
+namespace Mona {
+
+static const char _B64Table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+enum : uint8_t {
+	B64_SKIP = 0x80, // space or '='
+	B64_INVALID = 0xFF
+};
+/*!
+Byte to base64 value, B64_SKIP and B64_INVALID have the high bit set to check them together */
+static const uint8_t _ReverseB64Table[256] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x80, 0x80, 0x80, 0x80, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x80, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,   62, 0xFF, 0xFF, 0xFF,   63,
+	  52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0xFF, 0xFF, 0xFF, 0x80, 0xFF, 0xFF,
+	0xFF,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+	  15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+	  41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+static const char _HexTables[2][17] = { "0123456789abcdef", "0123456789ABCDEF" };
+
+
+/*
+Vectorized kernels, they process blocks while enough data remain and stop on the first block not valid (decoders),
+every one moves data and out to the end processed.
+Base64 (Wojciech Mula and Daniel Lemire, "Faster Base64 Encoding and Decoding using AVX2 Instructions"):
+- encoding reshuffles 3 bytes in 4 sextets by multiplications, and translates sextets in characters by offsets of a 16 bytes lookup table
+- decoding validates characters with two lookup tables indexed by nibbles (the and of their bitsets has to be null),
+translates them by offsets indexed by the high nibble, and packs 4 sextets in 3 bytes by multiply-add.
+Hexadecimal computes digit values by range comparisons and packs them by multiply-add */
+#if defined(_X86)
+
+static TARGET("ssse3") __m128i EncodeBase64(__m128i input) {
+	// 3 bytes ABC in 4 sextets of 16-bit words [00bbbbcc|ccdddddd] [00bbbbcc|ccdddddd] for every 4 bytes CBA
+	input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+	__m128i high = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+	__m128i low = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+	input = _mm_or_si128(high, low);
+	// sextet to character: +65 for 0-25, +71 for 26-51, -4 for 52-61, -19 for 62, -16 for 63
+	__m128i indices = _mm_sub_epi8(_mm_subs_epu8(input, _mm_set1_epi8(51)), _mm_cmpgt_epi8(input, _mm_set1_epi8(25)));
+	return _mm_add_epi8(input, _mm_shuffle_epi8(_mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0), indices));
+}
+static TARGET("ssse3") bool DecodeBase64(__m128i& input) {
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	__m128i high = _mm_and_si128(_mm_srli_epi16(input, 4), nibble);
+	__m128i invalid = _mm_and_si128(
+		_mm_shuffle_epi8(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A), _mm_and_si128(input, nibble)),
+		_mm_shuffle_epi8(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10), high));
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xFFFF)
+		return false;
+	// '/' shares high nibble of '+', its offset is just before
+	__m128i offsets = _mm_shuffle_epi8(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0), _mm_add_epi8(high, _mm_cmpeq_epi8(input, _mm_set1_epi8('/'))));
+	input = _mm_add_epi8(input, offsets);
+	// 4 sextets in 24 bits (00aaaaaa 00bbbbbb 00cccccc 00dddddd => aaaaaabb bbbbcccc ccdddddd)
+	input = _mm_madd_epi16(_mm_maddubs_epi16(input, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+	input = _mm_shuffle_epi8(input, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	return true;
+}
+static TARGET("ssse3") bool DecodeHex(__m128i& input) {
+	// digit = c-'0' < 10, letter = (c|0x20)-'a' < 6
+	__m128i digit = _mm_sub_epi8(input, _mm_set1_epi8('0'));
+	__m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+	__m128i letter = _mm_sub_epi8(_mm_or_si128(input, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+	__m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+	if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF)
+		return false;
+	input = _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_andnot_si128(isDigit, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+	input = _mm_maddubs_epi16(input, _mm_set1_epi16(0x0110)); // high*16 + low in 16 bits
+	return true;
+}
+
+static TARGET("ssse3") void ToBase64SSSE3(const char*& data, const char* end, char*& out) {
+	for (; (end - data) >= 16; data += 12, out += 16)
+		_mm_storeu_si128((__m128i*)out, EncodeBase64(_mm_loadu_si128((const __m128i*)data)));
+}
+static TARGET("ssse3") void FromBase64SSSE3(const char*& data, const char* end, char*& out) {
+	for (; (end - data) >= 24; data += 16, out += 12) {
+		__m128i block = _mm_loadu_si128((const __m128i*)data);
+		if (!DecodeBase64(block))
+			return;
+		_mm_storeu_si128((__m128i*)out, block); // 16 bytes, writable with 24 characters remaining
+	}
+}
+static TARGET("ssse3") void ToHexSSSE3(const char*& data, const char* end, char*& out, const char* table) {
+	const __m128i digits = _mm_loadu_si128((const __m128i*)table);
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	for (; (end - data) >= 16; data += 16, out += 32) {
+		__m128i block = _mm_loadu_si128((const __m128i*)data);
+		__m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(block, 4), nibble));
+		__m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(block, nibble));
+		_mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(high, low));
+		_mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi8(high, low));
+	}
+}
+static TARGET("ssse3") void FromHexSSSE3(const char*& data, const char* end, char*& out) {
+	for (; (end - data) >= 32; data += 32, out += 16) {
+		__m128i first = _mm_loadu_si128((const __m128i*)data);
+		__m128i second = _mm_loadu_si128((const __m128i*)(data + 16));
+		if (!DecodeHex(first) || !DecodeHex(second))
+			return;
+		_mm_storeu_si128((__m128i*)out, _mm_packus_epi16(first, second));
+	}
+}
+
+static TARGET("avx2") void ToBase64AVX2(const char*& data, const char* end, char*& out) {
+	for (; (end - data) >= 32; data += 24, out += 32) {
+		// 12 bytes by 128-bit lane
+		__m256i input = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)data)), _mm_loadu_si128((const __m128i*)(data + 12)), 1);
+		input = _mm256_shuffle_epi8(input, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1, 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		__m256i high = _mm256_mulhi_epu16(_mm256_and_si256(input, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+		__m256i low = _mm256_mullo_epi16(_mm256_and_si256(input, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+		input = _mm256_or_si256(high, low);
+		__m256i indices = _mm256_sub_epi8(_mm256_subs_epu8(input, _mm256_set1_epi8(51)), _mm256_cmpgt_epi8(input, _mm256_set1_epi8(25)));
+		const __m256i offsets = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0, 65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+		_mm256_storeu_si256((__m256i*)out, _mm256_add_epi8(input, _mm256_shuffle_epi8(offsets, indices)));
+	}
+}
+static TARGET("avx2") void FromBase64AVX2(const char*& data, const char* end, char*& out) {
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	const __m256i lowBits = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m256i highBits = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m256i offsets = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+	for (; (end - data) >= 48; data += 32, out += 24) {
+		__m256i input = _mm256_loadu_si256((const __m256i*)data);
+		__m256i high = _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble);
+		__m256i invalid = _mm256_and_si256(_mm256_shuffle_epi8(lowBits, _mm256_and_si256(input, nibble)), _mm256_shuffle_epi8(highBits, high));
+		if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(invalid, _mm256_setzero_si256())) != -1)
+			return;
+		input = _mm256_add_epi8(input, _mm256_shuffle_epi8(offsets, _mm256_add_epi8(high, _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/')))));
+		input = _mm256_madd_epi16(_mm256_maddubs_epi16(input, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+		input = _mm256_shuffle_epi8(input, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+		// 12 bytes by lane to 24 contiguous bytes, 32 bytes written (writable with 48 characters remaining)
+		_mm256_storeu_si256((__m256i*)out, _mm256_permutevar8x32_epi32(input, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7)));
+	}
+}
+static TARGET("avx2") void ToHexAVX2(const char*& data, const char* end, char*& out, const char* table) {
+	const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)table));
+	const __m256i nibble = _mm256_set1_epi8(0x0F);
+	for (; (end - data) >= 32; data += 32, out += 64) {
+		// 64-bit quarters ordered 0 2 1 3 to unpack by lane 0 1 then 2 3
+		__m256i block = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i*)data), 0xD8);
+		__m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble));
+		__m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(block, nibble));
+		_mm256_storeu_si256((__m256i*)out, _mm256_unpacklo_epi8(high, low));
+		_mm256_storeu_si256((__m256i*)(out + 32), _mm256_unpackhi_epi8(high, low));
+	}
+}
+static TARGET("avx2") void FromHexAVX2(const char*& data, const char* end, char*& out) {
+	for (; (end - data) >= 64; data += 64, out += 32) {
+		__m256i result[2];
+		for (uint8_t i = 0; i < 2; ++i) {
+			__m256i input = _mm256_loadu_si256((const __m256i*)(data + i * 32));
+			__m256i digit = _mm256_sub_epi8(input, _mm256_set1_epi8('0'));
+			__m256i isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+			__m256i letter = _mm256_sub_epi8(_mm256_or_si256(input, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+			__m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+			if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) != -1)
+				return;
+			input = _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, isDigit);
+			result[i] = _mm256_maddubs_epi16(input, _mm256_set1_epi16(0x0110));
+		}
+		_mm256_storeu_si256((__m256i*)out, _mm256_permute4x64_epi64(_mm256_packus_epi16(result[0], result[1]), 0xD8));
+	}
+}
+
+static void ToBase64Vector(const char*& data, const char* end, char*& out) {
+	if (CPU::Has(CPU::FEATURE_AVX2))
+		ToBase64AVX2(data, end, out);
+	if (CPU::Has(CPU::FEATURE_SSSE3))
+		ToBase64SSSE3(data, end, out);
+}
+static void FromBase64Vector(const char*& data, const char* end, char*& out) {
+	if (CPU::Has(CPU::FEATURE_AVX2))
+		FromBase64AVX2(data, end, out);
+	if (CPU::Has(CPU::FEATURE_SSSE3))
+		FromBase64SSSE3(data, end, out);
+}
+static void ToHexVector(const char*& data, const char* end, char*& out, const char* table) {
+	if (CPU::Has(CPU::FEATURE_AVX2))
+		ToHexAVX2(data, end, out, table);
+	if (CPU::Has(CPU::FEATURE_SSSE3))
+		ToHexSSSE3(data, end, out, table);
+}
+static void FromHexVector(const char*& data, const char* end, char*& out) {
+	if (CPU::Has(CPU::FEATURE_AVX2))
+		FromHexAVX2(data, end, out);
+	if (CPU::Has(CPU::FEATURE_SSSE3))
+		FromHexSSSE3(data, end, out);
+}
+
+#elif defined(_ARM64)
+
+static void ToBase64Vector(const char*& data, const char* end, char*& out) {
+	const uint8x16x4_t table = { { vld1q_u8(BIN _B64Table), vld1q_u8(BIN _B64Table + 16), vld1q_u8(BIN _B64Table + 32), vld1q_u8(BIN _B64Table + 48) } };
+	const uint8x16_t mask = vdupq_n_u8(0x3F);
+	for (; (end - data) >= 48; data += 48, out += 64) {
+		uint8x16x3_t input = vld3q_u8(BIN data);
+		uint8x16x4_t output;
+		output.val[0] = vqtbl4q_u8(table, vshrq_n_u8(input.val[0], 2));
+		output.val[1] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(input.val[0], 4), vshrq_n_u8(input.val[1], 4)), mask));
+		output.val[2] = vqtbl4q_u8(table, vandq_u8(vorrq_u8(vshlq_n_u8(input.val[1], 2), vshrq_n_u8(input.val[2], 6)), mask));
+		output.val[3] = vqtbl4q_u8(table, vandq_u8(input.val[2], mask));
+		vst4q_u8(BIN out, output);
+	}
+}
+static void FromBase64Vector(const char*& data, const char* end, char*& out) {
+	const uint8x16x4_t low = { { vld1q_u8(_ReverseB64Table), vld1q_u8(_ReverseB64Table + 16), vld1q_u8(_ReverseB64Table + 32), vld1q_u8(_ReverseB64Table + 48) } };
+	const uint8x16x4_t high = { { vld1q_u8(_ReverseB64Table + 64), vld1q_u8(_ReverseB64Table + 80), vld1q_u8(_ReverseB64Table + 96), vld1q_u8(_ReverseB64Table + 112) } };
+	const uint8x16_t offset = vdupq_n_u8(64);
+	for (; (end - data) >= 64; data += 64, out += 48) {
+		uint8x16x4_t input = vld4q_u8(BIN data);
+		uint8x16_t invalid = vdupq_n_u8(0);
+		for (uint8_t i = 0; i < 4; ++i) {
+			// characters >= 128 are out of both tables and keep their high bit in the check
+			uint8x16_t value = vqtbx4q_u8(vqtbl4q_u8(low, input.val[i]), high, vsubq_u8(input.val[i], offset));
+			invalid = vorrq_u8(invalid, vorrq_u8(value, input.val[i]));
+			input.val[i] = value;
+		}
+		if (vmaxvq_u8(invalid) & 0x80)
+			return;
+		uint8x16x3_t output;
+		output.val[0] = vorrq_u8(vshlq_n_u8(input.val[0], 2), vshrq_n_u8(input.val[1], 4));
+		output.val[1] = vorrq_u8(vshlq_n_u8(input.val[1], 4), vshrq_n_u8(input.val[2], 2));
+		output.val[2] = vorrq_u8(vshlq_n_u8(input.val[2], 6), input.val[3]);
+		vst3q_u8(BIN out, output);
+	}
+}
+static void ToHexVector(const char*& data, const char* end, char*& out, const char* table) {
+	const uint8x16_t digits = vld1q_u8(BIN table);
+	for (; (end - data) >= 16; data += 16, out += 32) {
+		uint8x16_t input = vld1q_u8(BIN data);
+		uint8x16x2_t output;
+		output.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(input, 4));
+		output.val[1] = vqtbl1q_u8(digits, vandq_u8(input, vdupq_n_u8(0x0F)));
+		vst2q_u8(BIN out, output);
+	}
+}
+static void FromHexVector(const char*& data, const char* end, char*& out) {
+	for (; (end - data) >= 32; data += 32, out += 16) {
+		uint8x16x2_t input = vld2q_u8(BIN data);
+		uint8x16_t valid = vdupq_n_u8(0xFF);
+		for (uint8_t i = 0; i < 2; ++i) {
+			uint8x16_t digit = vsubq_u8(input.val[i], vdupq_n_u8('0'));
+			uint8x16_t letter = vsubq_u8(vorrq_u8(input.val[i], vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+			uint8x16_t isDigit = vcltq_u8(digit, vdupq_n_u8(10));
+			valid = vandq_u8(valid, vorrq_u8(isDigit, vcltq_u8(letter, vdupq_n_u8(6))));
+			input.val[i] = vbslq_u8(isDigit, digit, vaddq_u8(letter, vdupq_n_u8(10)));
+		}
+		if (vminvq_u8(valid) != 0xFF)
+			return;
+		vst1q_u8(BIN out, vorrq_u8(vshlq_n_u8(input.val[0], 4), input.val[1]));
+	}
+}
+
+#else
+
+static void ToBase64Vector(const char*& data, const char* end, char*& out) {}
+static void FromBase64Vector(const char*& data, const char* end, char*& out) {}
+static void ToHexVector(const char*& data, const char* end, char*& out, const char* table) {}
+static void FromHexVector(const char*& data, const char* end, char*& out) {}
+
+#endif
+
+
+char* Codec::ToBase64(const char* data, uint32_t size, char* out) {
+	const char* end(data + size);
+	ToBase64Vector(data, end, out);
+	for (; (end - data) >= 3; data += 3) {
+		uint32_t value = (U(data[0]) << 16) | (U(data[1]) << 8) | U(data[2]);
+		*out++ = _B64Table[value >> 18];
+		*out++ = _B64Table[(value >> 12) & 0x3F];
+		*out++ = _B64Table[(value >> 6) & 0x3F];
+		*out++ = _B64Table[value & 0x3F];
+	}
+	if (data < end) { // 1 or 2 bytes remaining
+		uint32_t value = U(data[0]) << 16;
+		if ((end - data) > 1)
+			value |= U(data[1]) << 8;
+		*out++ = _B64Table[value >> 18];
+		*out++ = _B64Table[(value >> 12) & 0x3F];
+		*out++ = (end - data) > 1 ? _B64Table[(value >> 6) & 0x3F] : '=';
+		*out++ = '=';
+	}
+	return out;
+}
+
+char* Codec::FromBase64(const char* data, uint32_t size, char* out) {
+	const char* end(data + size);
+	uint32_t accumulator(0);
+	uint8_t bits(0);
+	while (data < end) {
+		if (!bits) {
+			// aligned on a 4 characters group: bulk decoding while characters are valid without space or padding
+			FromBase64Vector(data, end, out);
+			for (; (end - data) >= 4; data += 4, out += 3) {
+				uint8_t a = _ReverseB64Table[U(data[0])], b = _ReverseB64Table[U(data[1])], c = _ReverseB64Table[U(data[2])], d = _ReverseB64Table[U(data[3])];
+				if ((a | b | c | d) & 0x80)
+					break;
+				uint32_t value = (a << 18) | (b << 12) | (c << 6) | d;
+				out[0] = char(value >> 16);
+				out[1] = char(value >> 8);
+				out[2] = char(value);
+			}
+			if (data == end)
+				break;
+		}
+		uint8_t value = _ReverseB64Table[U(*data++)];
+		if (value & 0x80) {
+			if (value == B64_INVALID)
+				return NULL;
+			continue; // B64_SKIP
+		}
+		accumulator = (accumulator << 6) | value;
+		bits += 6;
+		if (bits >= 8) {
+			bits -= 8;
+			*out++ = char(accumulator >> bits);
+		}
+	}
+	return out;
+}
+
+char* Codec::ToHex(const char* data, uint32_t size, char* out, bool upperCase) {
+	const char* end(data + size);
+	const char* table(_HexTables[upperCase ? 1 : 0]);
+	ToHexVector(data, end, out, table);
+	while (data < end) {
+		*out++ = table[U(*data) >> 4];
+		*out++ = table[*data++ & 0x0F];
+	}
+	return out;
+}
+
+char* Codec::FromHex(const char* data, uint32_t size, char* out) {
+	const char* end(data + size);
+	FromHexVector(data, end, out);
+	static const struct HexValues : virtual Object {
+		HexValues() {
+			memset(values, 0xFF, sizeof(values));
+			for (uint8_t i = 0; i < 16; ++i)
+				values[U(_HexTables[0][i])] = values[U(_HexTables[1][i])] = i;
+		}
+		uint8_t values[256];
+	} Hex;
+	for (; (end - data) >= 2; data += 2) {
+		uint8_t high = Hex.values[U(data[0])], low = Hex.values[U(data[1])];
+		if ((high | low) & 0xF0)
+			break; // not hexadecimal, decoded as before without check
+		*out++ = char((high << 4) | low);
+	}
+	while (data < end) {
+		char left = *data++;
+		char right = data < end ? *data++ : '0';
+		// ASCII upper case (toupper of the C locale, without its cost)
+		left -= (left >= 'a' && left <= 'z') ? 32 : 0;
+		right -= (right >= 'a' && right <= 'z') ? 32 : 0;
+		*out++ = char((U(left - (left <= '9' ? '0' : '7')) << 4) | ((right - (right <= '9' ? '0' : '7')) & 0x0F));
+	}
+	return out;
+}
+
+
+} // namespace Mona
@@ -0,0 +1,46 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+
+namespace Mona {
+
+/*!
+Base64 and hexadecimal codecs writing directly to memory, vectorized by blocks (AVX2 or SSSE3 selected at runtime,
+NEON on ARM64) with a scalar fallback. Decoders validate blocks in bulk and let the scalar code process the rest,
+so results are the same whatever the instruction set */
+struct Codec : virtual Static {
+	/*!
+	Write base64 of data with '=' padding to out (4*ceil(size/3) bytes), returns the end written */
+	static char* ToBase64(const char* data, uint32_t size, char* out);
+	/*!
+	Decode base64 data to out (3*ceil(size/4) bytes maximum), spaces and '=' are ignored, incomplete trailing bits dropped.
+	Returns the end written or null if data contains an invalid character, out can be data to decode in-place */
+	static char* FromBase64(const char* data, uint32_t size, char* out);
+
+	/*!
+	Write hexadecimal of data to out (2*size bytes), returns the end written */
+	static char* ToHex(const char* data, uint32_t size, char* out, bool upperCase = false);
+	/*!
+	Decode hexadecimal data to out (ceil(size/2) bytes) without checking digits, an odd last digit is completed by '0'.
+	Returns the end written, out can be data to decode in-place */
+	static char* FromHex(const char* data, uint32_t size, char* out);
+};
+
+
+} // namespace Mona
@@ -0,0 +1,75 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Memory/Bytes.h"
+
+namespace Mona {
+
+/*!
+Exact conversions between decimal numbers and binary floating point, integer writing, and SWAR tools to parse decimal digits 8 by 8 */
+struct Decimal : virtual Static {
+	/*!
+	Convert mantissa x 10^exponent to the nearest double (correctly rounded), with the Clinger fast path when exact
+	or else the Eisel-Lemire algorithm. Returns false in the rare cases where the nearest value can't be decided
+	without a big number arithmetic, beyond the limits returns 0 or infinity */
+	static bool ToDouble(uint64_t mantissa, int32_t exponent, double& result);
+	/*!
+	Same as ToDouble for a float */
+	static bool ToFloat(uint64_t mantissa, int32_t exponent, float& result);
+
+	/*!
+	Write value in buffer (at least 20 bytes) without null termination, returns size written */
+	static uint8_t WriteUInt(uint64_t value, char* buffer);
+	/*!
+	Write value in buffer (at least 20 bytes) without null termination, returns size written */
+	static uint8_t WriteInt(int64_t value, char* buffer);
+	/*!
+	Write the shortest decimal representation which converts back to value (Ryu), with the printf %.16g layout
+	(scientific notation if the decimal exponent is inferior to -4 or superior to 15).
+	Buffer has to have at least 25 bytes, returns size written (without null termination) */
+	static uint8_t WriteDouble(double value, char* buffer);
+	/*!
+	Same as WriteDouble for a float, with the printf %.8g layout */
+	static uint8_t WriteFloat(float value, char* buffer);
+
+	/*!
+	True if the 8 characters are decimal digits */
+	static bool Is8Digits(const char* digits) { return Is8Digits(Read8(digits)); }
+	/*!
+	Value of 8 decimal digits, digits have to be checked before with Is8Digits */
+	static uint32_t Parse8Digits(const char* digits) { return Parse8Digits(Read8(digits)); }
+
+private:
+	static uint64_t Read8(const char* digits) {
+		uint64_t value;
+		memcpy(&value, digits, 8);
+		return Bytes::ORDER_NATIVE == Bytes::ORDER_LITTLE_ENDIAN ? value : Bytes::Flip64(value);
+	}
+	static bool Is8Digits(uint64_t value) {
+		return (((value & 0xF0F0F0F0F0F0F0F0) | (((value + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333);
+	}
+	static uint32_t Parse8Digits(uint64_t value) {
+		value -= 0x3030303030303030;
+		value = (value * 10) + (value >> 8); // 2 digits by byte
+		return uint32_t((((value & 0x000000FF000000FF) * (100 + (1000000ull << 32))) + (((value >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32)))) >> 32);
+	}
+};
+
+
+} // namespace Mona
@@ -16,6 +16,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Format/String.h"
 #include "Mona/Util/Exceptions.h"
+#include "Mona/Format/Decimal.h"
 #include <limits>
 #include <cctype>
 
@@ -140,10 +141,195 @@ string& String::replace(string& str, const string& what, const string& with) {
 	return str;
 }
 
+// Value of an alphanumeric digit, 0xFF if not alphanumeric
+static uint8_t Digit(char c) {
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'z')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'Z')
+		return c - 'A' + 10;
+	return 0xFF;
+}
+
+template<uint8_t base>
+static const char* SkipDigits(const char* current, const char* end) {
+	if (base == 10) {
+		while ((end - current) >= 8 && Decimal::Is8Digits(current))
+			current += 8;
+	}
+	while (current < end && Digit(*current) < base)
+		++current;
+	return current;
+}
+
+enum NumberState {
+	NUMBER_EMPTY = 0,
+	NUMBER_PARTIAL,
+	NUMBER_COMPLETE
+};
+
+struct Number {
+	const char*	integers;
+	uint32_t	integersSize;
+	const char*	decimals;
+	uint32_t	decimalsSize;
+	bool		negative;
+};
+
+template<uint8_t base>
+static NumberState ScanNumber(const char* value, size_t size, Number& number) {
+	const char* end(value + (size == string::npos ? strlen(value) : size));
+	// trim beginning
+	number.negative = false;
+	while (value < end && *value) {
+		if (*value == '-')
+			number.negative = !number.negative; // double -- = +
+		else if (*value != '+' && *value != ' ' && U(*value) >= 32 && *value != 127)
+			break;
+		++value;
+	}
+	number.integers = value;
+	value = SkipDigits<base>(value, end);
+	if (value == number.integers)
+		return NUMBER_EMPTY;
+	number.integersSize = value - number.integers;
+	number.decimals = value;
+	number.decimalsSize = 0;
+	if (value < end && (*value == '.' || *value == ',')) {
+		number.decimals = ++value;
+		value = SkipDigits<base>(value, end);
+		number.decimalsSize = value - number.decimals;
+	}
+	// stop but accept a partial conversion!
+	return (value < end && *value) ? NUMBER_PARTIAL : NUMBER_COMPLETE;
+}
+
+template<uint8_t base, typename Type>
+static typename enable_if<is_integral<Type>::value, Type>::type ToNumber(const Number& number) {
+	// exceeds, choose to round to the max/min! is more accurate with an input-user parsing
+	uint64_t max(numeric_limits<Type>::max());
+	if (number.negative)
+		max = is_signed<Type>::value ? max + 1 : 0;
+	uint64_t value(0);
+	const char* digits(number.integers);
+	uint32_t size(number.integersSize);
+	if (base == 10) {
+		while (size >= 8 && value < 100000000000ull) {
+			value = value * 100000000 + Decimal::Parse8Digits(digits);
+			digits += 8;
+			size -= 8;
+		}
+	}
+	while (size--) {
+		uint8_t digit = Digit(*digits++);
+		if (digit > max || value > (max - digit) / base) {
+			value = max;
+			break;
+		}
+		value = value * base + digit;
+	}
+	if (value > max)
+		value = max;
+	if (is_same<Type, bool>::value && !value && max) {
+		// as a cast from a floating point, 0.1 is true
+		for (uint32_t i = 0; i < number.decimalsSize && !value; ++i)
+			value = number.decimals[i] != '0';
+	}
+	return number.negative ? Type(0 - value) : Type(value);
+}
+
+static bool ToBinary(uint64_t mantissa, int32_t exponent, double& result) { return Decimal::ToDouble(mantissa, exponent, result); }
+static bool ToBinary(uint64_t mantissa, int32_t exponent, float& result) { return Decimal::ToFloat(mantissa, exponent, result); }
+static void FromString(const char* value, double& result) { result = strtod(value, NULL); }
+static void FromString(const char* value, float& result) { result = strtof(value, NULL); }
+
+// Take at most 19 significant digits in mantissa
+static void TakeDigits(const char*& digits, uint32_t& size, uint64_t& mantissa, uint8_t& count) {
+	while (count <= 11 && size >= 8) {
+		mantissa = mantissa * 100000000 + Decimal::Parse8Digits(digits);
+		digits += 8;
+		size -= 8;
+		count += 8;
+	}
+	while (count < 19 && size) {
+		mantissa = mantissa * 10 + (*digits++ - '0');
+		--size;
+		++count;
+	}
+}
+
+template<uint8_t base, typename Type>
+static typename enable_if<is_floating_point<Type>::value && base == 10, Type>::type ToNumber(const Number& number) {
+	// mantissa x 10^exponent with significant digits (without leading zeros)
+	const char* integers(number.integers);
+	uint32_t integersSize(number.integersSize);
+	while (integersSize && *integers == '0') {
+		++integers;
+		--integersSize;
+	}
+	const char* decimals(number.decimals);
+	uint32_t decimalsSize(number.decimalsSize);
+	int32_t exponent(0);
+	if (!integersSize) {
+		while (decimalsSize && *decimals == '0') {
+			++decimals;
+			--decimalsSize;
+			--exponent;
+		}
+	}
+	uint64_t mantissa(0);
+	uint8_t count(0);
+	TakeDigits(integers, integersSize, mantissa, count);
+	exponent += integersSize; // integer digits which exceed mantissa
+	uint32_t size(decimalsSize);
+	if (!integersSize) {
+		TakeDigits(decimals, decimalsSize, mantissa, count);
+		exponent -= size - decimalsSize;
+	}
+	// digits which exceed mantissa are not null?
+	bool truncated(false);
+	while (integersSize && !truncated)
+		truncated = integers[--integersSize] != '0';
+	while (decimalsSize && !truncated)
+		truncated = decimals[--decimalsSize] != '0';
+
+	Type result, upper;
+	if (!ToBinary(mantissa, exponent, result) || (truncated && (!ToBinary(mantissa + 1, exponent, upper) || upper != result))) {
+		// undecidable (very rare), use strtod which is exact with all the digits (no decimal point to be locale independent)
+		string buffer(number.integers, number.integersSize);
+		buffer.append(number.decimals, number.decimalsSize);
+		buffer.append("e-").append(to_string(number.decimalsSize));
+		FromString(buffer.c_str(), result);
+	}
+	if (result > numeric_limits<Type>::max()) // infinity, choose to round to the max! is more accurate with an input-user parsing
+		result = numeric_limits<Type>::max();
+	return number.negative ? -result : result;
+}
+
+template<uint8_t base, typename Type>
+static typename enable_if<is_floating_point<Type>::value && base != 10, Type>::type ToNumber(const Number& number) {
+	long double value(0), scale(1);
+	for (uint32_t i = 0; i < number.integersSize; ++i)
+		value = value * base + Digit(number.integers[i]);
+	for (uint32_t i = 0; i < number.decimalsSize; ++i) {
+		value = value * base + Digit(number.decimals[i]);
+		scale *= base;
+	}
+	value /= scale;
+	if (value > numeric_limits<Type>::max())
+		value = numeric_limits<Type>::max();
+	return Type(number.negative ? -value : value);
+}
+
 template<typename Type, uint8_t base>
 bool String::tryNumber(const char* value, size_t size, Type& result)  {
-	Exception ex;
-	return tryNumber<Type, base>(ex, value, size, result);
+	STATIC_ASSERT(is_arithmetic<Type>::value);
+	Number number;
+	if (base > 36 || !ScanNumber<base>(value, size, number))
+		return false;
+	result = ToNumber<base, Type>(number);
+	return true;
 }
 
 template<typename Type, uint8_t base>
@@ -153,102 +339,17 @@ bool String::tryNumber(Exception& ex, const char* value, size_t size, Type& resu
 		ex.set<Ex::Format>(base, " is impossible to represent with ascii table, maximum base is 36");
 		return false;
 	}
-	bool beginning = true;
-    uint8_t negative = 0;
-    long double number(0);
-    uint64_t comma(0);
-
-    const char* current(value);
-    while(*current && size-->0) {
-
-		if (iscntrl(*current) || *current==' ') {
-			if (!beginning) {
-				// accept a partial conversion!
-				ex.set<Ex::Format>(value, " is a partial number");
-				break;
-			}
-			// trim beginning
-			++current;
-			continue;
-      	}
-
-		if(ispunct(*current)) {
-			switch (*current++) {
-				case '-':
-					if (beginning) {
-						negative = negative ? 0 : 1; // double -- = +
-					}
-				case '+':
-					if (!beginning) {
-						// accept a partial conversion!
-						ex.set<Ex::Format>(value, " is a partial number");
-						break;
-					}
-					continue;
-				case '.':
-				case ',':
-					if (beginning || comma) {
-						// accept a partial conversion!
-						ex.set<Ex::Format>(value, " is a partial number");
-						break;
-					}
-					comma = 1;
-					continue;
-				default:;
-				// stop conversion!
-			}
-			// stop but accept a partial conversion!
-			ex.set<Ex::Format>(value, " is a partial number");
-			break; 
-		}
-
-      int8_t value = *current - '0';
-      if (value > 9) {
-        // is letter!
-        if (value >= 49)
-          value -= 39; // is lower letter
-        else
-          value -= 7; // is upper letter
-      }
-      if (value>=base) {
-		// stop but accept a partial conversion!
-		ex.set<Ex::Format>(value, " is a partial number");
-        break;
-	  }
-   
-      if (beginning) {
-        beginning = false;
-      }
-
-      number = number * base + value;
-      comma *= base;
-      ++current;
-    }
-
-	if (beginning) {
-		ex.set<Ex::Format>("Empty string is not a number");
-		return false;
+	Number number;
+	switch (ScanNumber<base>(value, size, number)) {
+		case NUMBER_EMPTY:
+			ex.set<Ex::Format>("Empty string is not a number");
+			return false;
+		case NUMBER_PARTIAL:
+			// accept a partial conversion!
+			ex.set<Ex::Format>(string(value, size == string::npos ? strlen(value) : size), " is a partial number");
+		default:;
 	}
-
-	if (comma) {
-		number /= comma;
-	}
-
-	if ((number - negative) > numeric_limits<Type>::max()) {
-      // exceeds, choose to round to the max! is more accurate with an input-user parsing
-      number = numeric_limits<Type>::max() + negative;
-    }
-
-	if (negative) {
-      if(is_unsigned<Type>::value) {
-        // exceeds, choose to round to the min! is more accurate with an input-user parsing
-        number = 0;
-      } else {
-        number *= -1;
-      }
-    }
-
-	result = (Type)number;
+	result = ToNumber<base, Type>(number);
 	return true;
 }
 
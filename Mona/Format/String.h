@@ -18,6 +18,8 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Memory/Packet.h"
+#include "Mona/Format/Decimal.h"
+#include "Mona/Format/Codec.h"
 #include "Mona/Timing/Date.h"
 #include <functional>
 
@@ -258,11 +260,7 @@ struct String : std::string {
 				buffer.resize(count);
 			out = (char*)buffer.data();
 		}
-		while (size-->0) {
-			char left = toupper(*value++);
-			char right = size-- ? toupper(*value++) : '0';
-			*out++ = ((left - (left <= '9' ? '0' : '7')) << 4) | ((right - (right <= '9' ? '0' : '7')) & 0x0F);
-		}
+		Codec::FromHex(value, uint32_t(size), out);
 		if(!append)
 			buffer.resize(count);
 		return buffer;
@@ -340,6 +338,22 @@ struct String : std::string {
 	}
 #endif
 
+	/*!
+	Append a number written by a Decimal writer */
+	template <typename OutType, typename ValueType>
+	static OutType& AppendNumber(OutType& out, uint8_t(*write)(ValueType, char*), ValueType value) {
+		char buffer[32];
+		return (OutType&)out.append(buffer, write(value, buffer));
+	}
+	/*!
+	Append a number written by a Decimal writer, directly in the reserved capacity of the Buffer */
+	template <typename ValueType>
+	static Buffer& AppendNumber(Buffer& out, uint8_t(*write)(ValueType, char*), ValueType value) {
+		uint32_t size = out.size();
+		out.resize(size + 32, true);
+		return out.resize(size + write(value, out.data() + size), true);
+	}
+
 	// match le "char" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, char value, Args&&... args) {
@@ -349,97 +363,73 @@ struct String : std::string {
 	// match le "signed char" cas
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, signed char value, Args&&... args) {
-		char buffer[8];
-		sprintf(buffer, "%hhd", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteInt, int64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "short" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, short value, Args&&... args) {
-		char buffer[8];
-		sprintf(buffer, "%hd", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteInt, int64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "int" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, int value, Args&&... args) {
-		char buffer[16];
-		sprintf(buffer, "%d", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteInt, int64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "long" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, long value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%ld", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteInt, int64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "unsigned char" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned char value, Args&&... args) {
-		char buffer[8];
-		sprintf(buffer, "%hhu", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteUInt, uint64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "unsigned short" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned short value, Args&&... args) {
-		char buffer[8];
-		sprintf(buffer, "%hu", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteUInt, uint64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "unsigned int" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned int value, Args&&... args) {
-		char buffer[16];
-		sprintf(buffer, "%u", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteUInt, uint64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "unsigned long" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned long value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%lu", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteUInt, uint64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "int64_t" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, long long value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%lld", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteInt, int64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "uint64_t" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, unsigned long long value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%llu", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteUInt, uint64_t(value)), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "float" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, float value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%.8g", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteFloat, value), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "double" case
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, double value, Args&&... args) {
-		char buffer[32];
-		sprintf(buffer, "%.16g", value);
-		return Append<OutType>((OutType&)out.append(buffer,strlen(buffer)), std::forward<Args>(args)...);
+		return Append<OutType>(AppendNumber(out, Decimal::WriteDouble, value), std::forward<Args>(args)...);
 	}
 
 	/// \brief match "bool" case
@@ -579,9 +569,16 @@ struct String : std::string {
 		}
 		char ref = hex.options&HEX_UPPER_CASE ? '7' : 'W';
 		char value;
+		if (!(hex.options&HEX_CPP)) {
+			if (skipLeft) {
+				value = (*data++) & 0x0F;
+				value += value > 9 ? ref : '0';
+				out.append(&value, 1);
+			}
+			return Append<OutType>(AppendHex(out, data, end - data, (hex.options&HEX_UPPER_CASE) ? true : false), std::forward<Args>(args)...);
+		}
 		while (data<end) {
-			if (hex.options&HEX_CPP)
-				out.append(EXPC("\\x"));
+			out.append(EXPC("\\x"));
 			value = U(*data) >> 4;
 			if (!skipLeft) {
 				value += value > 9 ? ref : '0';
@@ -594,6 +591,27 @@ struct String : std::string {
 		}
 		return Append<OutType>(out, std::forward<Args>(args)...);
 	}
+	/*!
+	Append hexadecimal of data by chunks written with Codec::ToHex */
+	template <typename OutType>
+	static OutType& AppendHex(OutType& out, const char* data, uint32_t size, bool upperCase) {
+		char buffer[256];
+		while (size) {
+			uint32_t count = size < sizeof(buffer) / 2 ? size : sizeof(buffer) / 2;
+			out.append(buffer, Codec::ToHex(data, count, buffer, upperCase) - buffer);
+			data += count;
+			size -= count;
+		}
+		return out;
+	}
+	/*!
+	Append hexadecimal of data directly in the reserved capacity of the Buffer */
+	static Buffer& AppendHex(Buffer& out, const char* data, uint32_t size, bool upperCase) {
+		uint32_t oldSize = out.size();
+		out.resize(oldSize + size * 2, true);
+		Codec::ToHex(data, size, STR out.data() + oldSize, upperCase);
+		return out;
+	}
 	template <typename OutType, typename Type, typename ...Args>
 	static OutType& Append(OutType& out, const Object<Type>& object, Args&&... args) {
 		bool first = true;
@@ -609,16 +627,17 @@ struct String : std::string {
 		return Append<OutType>(out, std::forward<Args>(args)...);
 	}
 	struct Log : virtual Mona::Object {
-		Log(const char* level, const std::string& file, long line, const std::string& message, uint32_t threadId = 0) : threadId(threadId), level(level), file(file), line(line), message(message) {}
+		Log(const char* level, const std::string& file, long line, const std::string& message, uint32_t threadId = 0, int64_t time = 0) : threadId(threadId), time(time), level(level), file(file), line(line), message(message) {}
 		const char*			level;
 		const std::string&	file;
 		const long			line;
 		const std::string&	message;
 		const uint32_t		threadId;
+		const int64_t		time; // 0 means now
 	};
 	template <typename OutType, typename ...Args>
 	static OutType& Append(OutType& out, const Log& log, Args&&... args) {
-		uint32_t size = Mona::Date().format("%d/%m %H:%M:%S.%c  ", out).size();
+		uint32_t size = Mona::Date(log.time ? log.time : Mona::Time::Now()).format("%d/%m %H:%M:%S.%c  ", out).size();
 		out.append(7 - (Append<OutType>(out,log.level).size() - size), ' ');
 		if (log.threadId) {
 			Append<OutType>(out, log.threadId);
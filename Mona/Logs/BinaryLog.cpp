@@ -0,0 +1,180 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Logs/BinaryLog.h"
+#include "Mona/Logs/Logs.h"
+#include "Mona/Disk/File.h"
+
+using namespace std;
+
+namespace Mona {
+
+#define BINARYLOG_VERSION 1
+
+bool BinaryLog::Decode(const char* data, uint32_t size, string& message) {
+	BinaryReader reader(data, size, Bytes::ORDER_LITTLE_ENDIAN);
+	while (reader.available()) {
+		switch (reader.read8()) {
+			case TYPE_STRING: {
+				uint32_t size(reader.read7Bit<uint32_t>());
+				if (size > reader.available())
+					return false;
+				message.append(reader.current(), size);
+				reader.next(size);
+				break;
+			}
+			case TYPE_CHAR:
+				String::Append(message, reader.read());
+				break;
+			case TYPE_BOOL:
+				String::Append(message, reader.readBool());
+				break;
+			case TYPE_INT:
+				String::Append(message, (long long)ReadInt(reader));
+				break;
+			case TYPE_UINT:
+				String::Append(message, (unsigned long long)reader.read7Bit<uint64_t>());
+				break;
+			case TYPE_FLOAT:
+				String::Append(message, reader.readFloat());
+				break;
+			case TYPE_DOUBLE:
+				String::Append(message, reader.readDouble());
+				break;
+			default:
+				return false;
+		}
+	}
+	return true;
+}
+
+BinaryWriter& BinaryLog::Writer::begin(BinaryWriter& writer, uint8_t entry, int64_t time) {
+	if (!_time) {
+		// header
+		writer.write8(ENTRY_HEADER).write(EXPC("MLOG")).write8(BINARYLOG_VERSION).write64(time);
+		_time = time;
+	}
+	WriteInt(writer.write8(entry), time - _time);
+	_time = time;
+	return writer;
+}
+
+Buffer& BinaryLog::Writer::write(Buffer& buffer, LOG_LEVEL level, const string& file, long line, uint32_t thread, int64_t time, const Packet& args) {
+	BinaryWriter writer(buffer, Bytes::ORDER_LITTLE_ENDIAN);
+	if (!_time)
+		_files.clear(); // new stream
+	auto it = _files.lower_bound(file);
+	if (it == _files.end() || it->first != file) {
+		it = _files.emplace_hint(it, file, _files.size());
+		begin(writer, ENTRY_FILE, time).write7Bit<uint32_t>(it->second).write7Bit<uint32_t>(file.size()).write(file);
+	}
+	begin(writer, ENTRY_LOG, time).write8(level).write7Bit<uint32_t>(it->second).write7Bit<uint32_t>(line).write7Bit<uint32_t>(thread);
+	writer.write7Bit<uint32_t>(args.size()).write(args);
+	return buffer;
+}
+
+Buffer& BinaryLog::Writer::write(Buffer& buffer, int64_t time, const string& header, const char* data, uint32_t size) {
+	BinaryWriter writer(buffer, Bytes::ORDER_LITTLE_ENDIAN);
+	begin(writer, ENTRY_DUMP, time).write7Bit<uint32_t>(header.size()).write(header);
+	writer.write7Bit<uint32_t>(size).write(data, size);
+	return buffer;
+}
+
+bool BinaryLog::ToText(const char* data, uint32_t size, Buffer& text) {
+	BinaryReader reader(data, size, Bytes::ORDER_LITTLE_ENDIAN);
+	vector<string> files;
+	string message;
+	int64_t time(0);
+	while (reader.available()) {
+		uint8_t entry(reader.read8());
+		if (entry == ENTRY_HEADER) {
+			// new stream (file appended by a new process)
+			if (reader.available() < 13 || memcmp(reader.current(), EXPC("MLOG")) != 0)
+				return false;
+			reader.next(4);
+			if (reader.read8() != BINARYLOG_VERSION)
+				return false;
+			time = reader.read64();
+			files.clear();
+			continue;
+		}
+		if (!time)
+			return false; // no header
+		time += ReadInt(reader);
+		switch (entry) {
+			case ENTRY_FILE: {
+				uint32_t id(reader.read7Bit<uint32_t>());
+				if (id != files.size())
+					return false;
+				files.emplace_back();
+				uint32_t size(reader.read7Bit<uint32_t>());
+				if (size > reader.available())
+					return false;
+				files.back().assign(reader.current(), size);
+				reader.next(size);
+				break;
+			}
+			case ENTRY_LOG: {
+				LOG_LEVEL level(reader.read8());
+				uint32_t id(reader.read7Bit<uint32_t>());
+				long line(reader.read7Bit<uint32_t>());
+				uint32_t thread(reader.read7Bit<uint32_t>());
+				uint32_t size(reader.read7Bit<uint32_t>());
+				if (!level || level > LOG_TRACE || id >= files.size() || size > reader.available())
+					return false;
+				message.clear();
+				if (!Decode(reader.current(), size, message))
+					return false;
+				reader.next(size);
+				String::Append(text, String::Log(Logs::LevelToString(level), files[id], line, message, thread, time));
+				break;
+			}
+			case ENTRY_DUMP: {
+				uint32_t size(reader.read7Bit<uint32_t>());
+				if (size > reader.available())
+					return false;
+				String::Append(text, Mona::Date(time).format("%d/%m %H:%M:%S.%c  ", message.erase()), string(reader.current(), size), '\n');
+				reader.next(size);
+				size = reader.read7Bit<uint32_t>();
+				if (size > reader.available())
+					return false;
+				text.append(reader.current(), size);
+				reader.next(size);
+				break;
+			}
+			default:
+				return false;
+		}
+	}
+	return true;
+}
+
+bool BinaryLog::ToText(Exception& ex, const Path& path, Buffer& text) {
+	File file(path, File::MODE_READ);
+	if (!file.load(ex))
+		return false;
+	Buffer buffer(range<uint32_t>(file.size()));
+	int readen = file.read(ex, buffer.data(), buffer.size());
+	if (readen < 0)
+		return false;
+	if (!ToText(buffer.data(), readen, text)) {
+		ex.set<Ex::Format>(path, " binary logs corrupted");
+		return false;
+	}
+	return true;
+}
+
+} // namespace Mona
@@ -0,0 +1,131 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Logs/Logger.h"
+#include "Mona/Format/BinaryWriter.h"
+#include "Mona/Format/BinaryReader.h"
+
+namespace Mona {
+
+/*!
+Binary logs with deferred formatting (NanoLog style):
+- Encode serializes log arguments as raw typed values (numbers and strings), other types are formatted on encoding,
+Decode rebuilds the String::Append text later (backend thread or reading tool).
+- Writer serializes logs in a compact binary stream (source files dictionary, time deltas, raw arguments),
+Reader converts it back to the text written by FileLogger */
+struct BinaryLog : virtual Static {
+	enum Type : uint8_t {
+		TYPE_STRING = 0,
+		TYPE_CHAR,
+		TYPE_BOOL,
+		TYPE_INT,
+		TYPE_UINT,
+		TYPE_FLOAT,
+		TYPE_DOUBLE
+	};
+
+	/*!
+	Append encoded arguments to buffer (little endian) */
+	template <typename ...Args>
+	static Buffer& Encode(Buffer& buffer, Args&&... args) {
+		BinaryWriter writer(buffer, Bytes::ORDER_LITTLE_ENDIAN);
+		Encode(writer, std::forward<Args>(args)...);
+		return buffer;
+	}
+	/*!
+	Append the text of encoded arguments to message, returns false if data are corrupted */
+	static bool Decode(const char* data, uint32_t size, std::string& message);
+
+	struct Writer : virtual Object {
+		Writer() : _time(0) {}
+		/*!
+		Write a log, the first write writes a header and the source file dictionary is written on the fly */
+		Buffer& write(Buffer& buffer, LOG_LEVEL level, const std::string& file, long line, uint32_t thread, int64_t time, const Packet& args);
+		Buffer& write(Buffer& buffer, int64_t time, const std::string& header, const char* data, uint32_t size);
+		/*!
+		Restart the stream (new file) */
+		void	reset() { _files.clear(); _time = 0; }
+	private:
+		BinaryWriter& begin(BinaryWriter& writer, uint8_t entry, int64_t time);
+
+		std::map<std::string, uint32_t> _files;
+		int64_t							_time;
+	};
+
+	/*!
+	Convert a binary logs stream to the text as FileLogger writes it in text mode,
+	returns false if data are corrupted (text contains then the logs decoded before) */
+	static bool ToText(const char* data, uint32_t size, Buffer& text);
+	static bool ToText(Exception& ex, const Path& path, Buffer& text);
+
+private:
+	enum Entry : uint8_t {
+		ENTRY_HEADER = 0, // "MLOG", version, base time
+		ENTRY_FILE, // source file dictionary: id, path
+		ENTRY_LOG,
+		ENTRY_DUMP
+	};
+
+	template <typename Type, typename ...Args>
+	static void Encode(BinaryWriter& writer, Type&& value, Args&&... args) {
+		Write(writer, std::forward<Type>(value));
+		Encode(writer, std::forward<Args>(args)...);
+	}
+	static void Encode(BinaryWriter& writer) {}
+
+	/*!
+	Signed integers are zigzag encoded (sign in low bit) in unsigned 7bit,
+	BinaryWriter::write7Bit<int64_t> shifts the signed value and loses its high bit beyond 2^62 */
+	static BinaryWriter& WriteInt(BinaryWriter& writer, int64_t value) { return writer.write7Bit<uint64_t>((uint64_t(value) << 1) ^ (0 - (uint64_t(value) >> 63))); }
+	static int64_t		 ReadInt(BinaryReader& reader) { uint64_t value(reader.read7Bit<uint64_t>()); return int64_t((value >> 1) ^ (0 - (value & 1))); }
+
+	static void Write(BinaryWriter& writer, const std::string& value) { writer.write8(TYPE_STRING).write7Bit<uint32_t>(value.size()).write(value); }
+	static void Write(BinaryWriter& writer, const char* value) { uint32_t size(strlen(value)); writer.write8(TYPE_STRING).write7Bit<uint32_t>(size).write(value, size); }
+	static void Write(BinaryWriter& writer, std::nullptr_t) { Write(writer, "null"); }
+	static void Write(BinaryWriter& writer, char value) { writer.write8(TYPE_CHAR).write(value); }
+	static void Write(BinaryWriter& writer, bool value) { writer.write8(TYPE_BOOL).writeBool(value); }
+	static void Write(BinaryWriter& writer, signed char value) { WriteInt(writer.write8(TYPE_INT), value); }
+	static void Write(BinaryWriter& writer, short value) { WriteInt(writer.write8(TYPE_INT), value); }
+	static void Write(BinaryWriter& writer, int value) { WriteInt(writer.write8(TYPE_INT), value); }
+	static void Write(BinaryWriter& writer, long value) { WriteInt(writer.write8(TYPE_INT), value); }
+	static void Write(BinaryWriter& writer, long long value) { WriteInt(writer.write8(TYPE_INT), value); }
+	static void Write(BinaryWriter& writer, unsigned char value) { writer.write8(TYPE_UINT).write7Bit<uint64_t>(value); }
+	static void Write(BinaryWriter& writer, unsigned short value) { writer.write8(TYPE_UINT).write7Bit<uint64_t>(value); }
+	static void Write(BinaryWriter& writer, unsigned int value) { writer.write8(TYPE_UINT).write7Bit<uint64_t>(value); }
+	static void Write(BinaryWriter& writer, unsigned long value) { writer.write8(TYPE_UINT).write7Bit<uint64_t>(value); }
+	static void Write(BinaryWriter& writer, unsigned long long value) { writer.write8(TYPE_UINT).write7Bit<uint64_t>(value); }
+	static void Write(BinaryWriter& writer, float value) { writer.write8(TYPE_FLOAT).writeFloat(value); }
+	static void Write(BinaryWriter& writer, double value) { writer.write8(TYPE_DOUBLE).writeDouble(value); }
+	/*!
+	Other types are formatted immediatly (can reference volatile data) */
+	template<typename Type>
+	static typename std::enable_if<!std::is_arithmetic<typename std::decay<Type>::type>::value &&
+		!std::is_convertible<Type, const char*>::value &&
+		!std::is_base_of<std::string, typename std::decay<Type>::type>::value>::type
+	Write(BinaryWriter& writer, Type&& value) {
+		thread_local std::string Text;
+		Write(writer, String::Assign(Text, std::forward<Type>(value)));
+		if (Text.size() > 0xFF) {
+			Text.resize(0xFF);
+			Text.shrink_to_fit();
+		}
+	}
+};
+
+} // namespace Mona
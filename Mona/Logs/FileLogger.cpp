@@ -16,67 +16,303 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Logs/FileLogger.h"
 #include "Mona/Logs/Logs.h"
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 
 using namespace std;
 
 namespace Mona {
 
-FileLogger::FileLogger(string&& dir, uint32_t sizeByFile, uint16_t rotation) : _sizeByFile(sizeByFile), _rotation(rotation),
-	_pFile(SET, Path(MAKE_FOLDER(dir), "0.log"), File::MODE_APPEND) {
+/*!
+Rename N.log to N+1.log from the older, deleting the files beyond rotation count, then first to 1.log.
+If pending is set, first is this pending file and 0.log is already the new current file */
+static void Shift(const string& dir, const char* extension, uint16_t rotation, const char* pending = NULL) {
+	// delete more older file + search the older file name (usefull when _rotation==0 => no rotation!) 
+	string name;
+	uint32_t maxNum(0);
+	Exception ex;
+	FileSystem::ForEach forEach([&](const string& path, uint16_t level) {
+		uint16_t num;
+		if (String::ICompare(FileSystem::GetExtension(path, name), extension + 1) != 0)
+			return true; // other log format
+		if (!String::tryNumber(FileSystem::GetBaseName(path, name), num) || (pending && !num))
+			return true;
+		if (rotation && num >= (rotation - 1))
+			FileSystem::Delete(ex, String(dir, num, extension));
+		else if (num > maxNum)
+			maxNum = num;
+		return true;
+	});
+	FileSystem::ListFiles(ex, dir, forEach);
+	// rename log files
+	while (maxNum) {
+		FileSystem::Rename(String(dir, maxNum, extension), String(dir, maxNum + 1, extension));
+		--maxNum;
+	}
+	if (!pending)
+		FileSystem::Rename(String(dir, 0, extension), String(dir, 1, extension));
+	else if (rotation == 1)
+		FileSystem::Delete(ex, pending);
+	else
+		FileSystem::Rename(pending, String(dir, 1, extension));
+}
+
+struct FileLogger::Rotation : Runner, virtual Object {
+	Rotation(const string& dir, const char* extension, uint16_t rotation, string&& pending) : Runner("FileLoggerRotation"),
+		_dir(dir), _extension(extension), _rotation(rotation), _pending(move(pending)) {}
+private:
+	bool run(Exception& ex) {
+		Shift(_dir, _extension, _rotation, _pending.c_str());
+		return true;
+	}
+	const string	_dir;
+	const char*		_extension;
+	const uint16_t	_rotation;
+	const string	_pending;
+};
+
+/*!
+Preallocated file mapped in memory, writings are a memcpy at the cursor, the file is truncated to the cursor on close.
+The cursor is persisted in a trailer after the preallocated part (magic + cursor), so on reopening a file not truncated (crash)
+the writing continues exactly after the last log */
+struct FileLogger::Mapping : virtual Object {
+	Mapping() : _handle(-1), _data(NULL), _capacity(0), _size(0) {}
+	~Mapping() { close(); }
+
+	bool		opened() const { return _data ? true : false; }
+	uint32_t	size() const { return _size; }
+
+	bool open(Exception& ex, const Path& path, uint32_t capacity, bool append) {
+		close();
+#if defined(_WIN32)
+		ex.set<Ex::Unsupported>("Mapped file logger unsupported on Windows");
+		return false;
+#else
+		_handle = ::open(path.c_str(), O_RDWR | O_CREAT | (append ? 0 : O_TRUNC), S_IRWXU);
+		if (_handle < 0) {
+			ex.set<Ex::Permission>("Impossible to open ", path, " file to write");
+			return false;
+		}
+		struct stat status;
+		if (flock(_handle, LOCK_EX | LOCK_NB) != 0 || ::fstat(_handle, &status) != 0) { // exclusive write as File!
+			ex.set<Ex::Permission>("Impossible to open ", path, " file to write");
+			close();
+			return false;
+		}
+		uint32_t size(range<uint32_t>(status.st_size));
+		uint64_t cursor;
+		if (readTrailer(size, cursor)) // not truncated (crash)
+			size -= TRAILER;
+		else
+			cursor = size; // closed properly, truncated to its content
+		if (!map(ex, max(capacity, size))) {
+			close();
+			return false;
+		}
+		setCursor(uint32_t(cursor));
+		return true;
+#endif
+	}
+	/*!
+	Returns false if not enough space */
+	bool write(const char* data, uint32_t size) {
+		if (size > (_capacity - _size))
+			return false;
+		memcpy(_data + _size, data, size);
+		setCursor(_size + size);
+		return true;
+	}
+	/*!
+	Extend the file to write size bytes, when a write is bigger than a segment */
+	bool grow(Exception& ex, uint32_t size) { return map(ex, _size + size); }
+
+	void close() {
+#if !defined(_WIN32)
+		if (_data)
+			munmap(_data, _capacity + TRAILER);
+		if (_handle >= 0) {
+			if (ftruncate(_handle, _size)) // remove the preallocated part unused and the trailer
+				;
+			::close(_handle);
+		}
+#endif
+		_handle = -1;
+		_data = NULL;
+		_capacity = _size = 0;
+	}
+
+private:
+	enum { TRAILER = 16 }; // magic (8 bytes) + cursor (uint64_t)
+	static const char* Magic() { return "MONAMAP\x01"; }
+
+	/*!
+	Check if the file ends with a trailer and read its cursor */
+	bool readTrailer(uint32_t size, uint64_t& cursor) {
+#if !defined(_WIN32)
+		char trailer[TRAILER];
+		if (size < TRAILER || pread(_handle, trailer, TRAILER, size - TRAILER) != TRAILER || memcmp(trailer, Magic(), 8) != 0)
+			return false;
+		memcpy(&cursor, trailer + 8, sizeof(cursor));
+		return cursor <= size - TRAILER;
+#else
+		return false;
+#endif
+	}
+	void setCursor(uint32_t size) {
+		_size = size;
+		uint64_t cursor(size);
+		memcpy(_data + _capacity + 8, &cursor, sizeof(cursor));
+	}
+
+	bool map(Exception& ex, uint32_t capacity) {
+#if !defined(_WIN32)
+		if (_data)
+			munmap(_data, _capacity + TRAILER);
+		_data = NULL;
+		_capacity = 0;
+#if defined(__APPLE__)
+		int error(ftruncate(_handle, capacity + TRAILER) ? errno : 0);
+#else
+		int error(posix_fallocate(_handle, 0, capacity + TRAILER)); // reserves blocks, no disk full during writings
+		if (error == EINVAL || error == EOPNOTSUPP)
+			error = ftruncate(_handle, capacity + TRAILER) ? errno : 0; // file system without allocation support
+#endif
+		if (error) {
+			ex.set<Ex::System::File>("Impossible to allocate ", capacity, " bytes of log file, ", strerror(error));
+			return false;
+		}
+		void* data(mmap(NULL, capacity + TRAILER, PROT_READ | PROT_WRITE, MAP_SHARED, _handle, 0));
+		if (data == MAP_FAILED) {
+			ex.set<Ex::System::File>("Impossible to map log file, ", strerror(errno));
+			return false;
+		}
+		_data = (char*)data;
+		_capacity = capacity;
+		memcpy(_data + _capacity, Magic(), 8);
+		setCursor(_size);
+#endif
+		return true;
+	}
+
+	int			_handle;
+	char*		_data;
+	uint32_t	_capacity;
+	uint32_t	_size;
+};
+
+FileLogger::FileLogger(string&& dir, uint32_t sizeByFile, uint16_t rotation, bool binary, bool mapped) : _sizeByFile(sizeByFile), _rotation(rotation),
+	_extension(binary ? ".mlog" : ".log"), _pFile(SET, Path(MAKE_FOLDER(dir), '0', _extension), File::MODE_APPEND), _rotations(0) {
+	if (binary)
+		_pWriter.set();
+	if (mapped && sizeByFile) { // infinite log file (sizeByFile==0) can't be preallocated
+		_pRotator.set(Thread::PRIORITY_LOW);
+#if !defined(_WIN32)
+		_pMapping.set(); // opened on first write (as File)
+#endif
+	}
 	_written = range<uint32_t>(_pFile->size());
 }
 
+FileLogger::~FileLogger() {
+	_pMapping.reset(); // truncate current file
+	_pRotator.reset(); // wait end of rotations
+}
+
 bool FileLogger::log(LOG_LEVEL level, const Path& file, long line, const string& message) {
-	static string Buffer; // max size controlled by Logs system!
-	static Exception Ex;
-	String::Assign(Buffer, String::Log(Logs::LevelToString(level), file, line, message, Thread::CurrentId()));
-	if (!_pFile->write(Ex, Buffer.data(), Buffer.size())) {
-		_pFile.reset();
-		return false;
+	if (_pWriter) {
+		static Buffer Arguments;
+		BinaryLog::Encode(Arguments.clear(), message);
+		return logBinary(level, file, line, Packet(Arguments.data(), Arguments.size()));
 	}
-	manage(Buffer.size());
-	return true;
+	static string Buffer; // max size controlled by Logs system!
+	String::Assign(Buffer, String::Log(Logs::LevelToString(level), file, line, message, Logs::LogThread(), Logs::LogTime()));
+	return write(Buffer.data(), Buffer.size());
+}
+
+bool FileLogger::logBinary(LOG_LEVEL level, const Path& file, long line, const Packet& args) {
+	static Buffer Buffer; // max size controlled by Logs system!
+	_pWriter->write(Buffer.clear(), level, file, line, Logs::LogThread(), Logs::LogTime(), args);
+	return write(Buffer.data(), Buffer.size());
 }
 
 bool FileLogger::dump(const string& header, const char* data, uint32_t size) {
-	String buffer(String::Date("%d/%m %H:%M:%S.%c  "), header, '\n');
+	static Buffer Buffer;
+	if (_pWriter)
+		_pWriter->write(Buffer.clear(), Logs::LogTime(), header, data, size);
+	else
+		String::Assign(Buffer, String::Date("%d/%m %H:%M:%S.%c  "), header, '\n').append(data, size);
+	return write(Buffer.data(), Buffer.size());
+}
+
+bool FileLogger::write(const char* data, uint32_t size) {
 	Exception ex;
-	if (!_pFile->write(ex, buffer.data(), buffer.size()) || !_pFile->write(ex, data, size)) {
+	if (!_pMapping) {
+		if (!_pFile->write(ex, data, size)) {
+			_pFile.reset();
+			return false;
+		}
+		manage(size);
+		return true;
+	}
+	if (!_pMapping->opened() && !_pMapping->open(ex, *_pFile, _sizeByFile, true)) {
 		_pFile.reset();
 		return false;
 	}
-	manage(buffer.size() + size);
-	return true;
+	if (_pMapping->write(data, size))
+		return true;
+	// segment full
+	if (_pMapping->size() && !rotate(ex)) {
+		_pFile.reset();
+		return false;
+	}
+	if (_pMapping->write(data, size))
+		return true;
+	// bigger than a segment
+	if (!_pMapping->grow(ex, size)) {
+		_pFile.reset();
+		return false;
+	}
+	return _pMapping->write(data, size);
 }
 
 void FileLogger::manage(uint32_t written) {
 	if (!_sizeByFile || (_written += written) <= _sizeByFile) // don't use _pLogFile->size(true) to avoid disk access on every file log!
 		return; // _logSizeByFile==0 => inifinite log file! (user choice..)
-
 	_written = 0;
-	_pFile.set(Path(_pFile->parent(), "0.log"), File::MODE_WRITE); // override 0.log file!
-
-	// delete more older file + search the older file name (usefull when _rotation==0 => no rotation!) 
-	string name;
-	uint32_t maxNum(0);
-	Exception ex;
-	FileSystem::ForEach forEach([this, &ex, &name, &maxNum](const string& path, uint16_t level) {
-		uint16_t num;
-		if (!String::tryNumber(FileSystem::GetBaseName(path, name), num))
-			return true;
-		if (_rotation && num >= (_rotation - 1))
-			FileSystem::Delete(ex, String(_pFile->parent(), num, ".log"));
-		else if (num > maxNum)
-			maxNum = num;
-		return true;
-	});
-	FileSystem::ListFiles(ex, _pFile->parent(), forEach);
-	// rename log files
-	do {
-		FileSystem::Rename(String(_pFile->parent(), maxNum, ".log"), String(_pFile->parent(), maxNum + 1, ".log"));
-	} while (maxNum--);
+	if (_pRotator) {
+		Exception ex;
+		if (!rotate(ex))
+			_pFile.reset();
+		return;
+	}
+	_pFile.set(Path(_pFile->parent(), '0', _extension), File::MODE_WRITE); // override 0.log file!
+	if (_pWriter)
+		_pWriter->reset(); // new file has to be readable alone
+	Shift(_pFile->parent(), _extension, _rotation);
+}
 
+bool FileLogger::rotate(Exception& ex) {
+	// close current file, rename it to a pending name, and create a new 0.log, renamings and deletions are done by the rotator thread
+	String pending(_pFile->parent(), '~', Time::Now(), '.', _rotations++, _extension);
+	Path path(_pFile->parent(), '0', _extension);
+	if (_pMapping)
+		_pMapping->close();
+	else
+		_pFile.set(path, File::MODE_WRITE); // release handle
+	if (!FileSystem::Rename(path, pending)) {
+		ex.set<Ex::System::File>("Impossible to rename ", path, " to ", pending);
+		return false;
+	}
+	if (_pWriter)
+		_pWriter->reset(); // new file has to be readable alone
+	_pRotator->queue<Rotation>(path.parent(), _extension, _rotation, move(pending));
+	return _pMapping ? _pMapping->open(ex, path, _sizeByFile, false) : true;
 }
 
 } // namespace Mona
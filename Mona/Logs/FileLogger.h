@@ -18,7 +18,9 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Logs/Logger.h"
+#include "Mona/Logs/BinaryLog.h"
 #include "Mona/Disk/File.h"
+#include "Mona/Threading/ThreadQueue.h"
 
 namespace Mona {
 
@@ -27,19 +29,37 @@ struct FileLogger : Logger, virtual Object {
 		DEFAULT_SIZE_BY_FILE = 1000000,
 		DEFAULT_ROTATION = 10
 	};
-	FileLogger(std::string&& dir, uint32_t sizeByFile = DEFAULT_SIZE_BY_FILE, uint16_t rotation = DEFAULT_ROTATION);
+	/*!
+	If binary, logs are written in BinaryLog format in "N.mlog" files (see BinaryLog::ToText to read them).
+	If mapped, logs are written in a preallocated memory-mapped file of sizeByFile bytes (Windows: normal writes),
+	rotation is then a file switch with one rename, the older files being renamed and deleted by a background thread */
+	FileLogger(std::string&& dir, uint32_t sizeByFile = DEFAULT_SIZE_BY_FILE, uint16_t rotation = DEFAULT_ROTATION, bool binary = false, bool mapped = false);
+	~FileLogger();
 
 	bool enabled() const { return _pFile ? true : false; }
 
 	bool log(LOG_LEVEL level, const Path& file, long line, const std::string& message) override;
 	bool dump(const std::string& header, const char* data, uint32_t size) override;
+
+	bool binary() const override { return _pWriter ? true : false; }
+	bool logBinary(LOG_LEVEL level, const Path& file, long line, const Packet& args) override;
 private:
+	bool write(const char* data, uint32_t size);
 	void manage(uint32_t written);
+	bool rotate(Exception& ex);
+
+	struct Mapping;
+	struct Rotation;
 
+	Unique<BinaryLog::Writer>	_pWriter;
+	const char*					_extension;
 	Unique<File>		_pFile;
 	uint32_t			_written;
 	uint16_t			_rotation;
 	uint32_t			_sizeByFile;
+	Unique<Mapping>		_pMapping;
+	Unique<ThreadQueue>	_pRotator;
+	uint32_t			_rotations;
 };
 
 } // namespace Mona
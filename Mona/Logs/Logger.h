@@ -52,6 +52,11 @@ struct Logger : virtual Object {
 
 	virtual bool log(LOG_LEVEL level, const Path& file, long line, const std::string& message) = 0;
 	virtual bool dump(const std::string& header, const char* data, uint32_t size) = 0;
+
+	/*!
+	Returns true to get logs by logBinary rather than log, with arguments encoded by BinaryLog (formatting deferred) */
+	virtual bool binary() const { return false; }
+	virtual bool logBinary(LOG_LEVEL level, const Path& file, long line, const Packet& args) { return false; }
 };
 
 } // namespace Mona
@@ -16,6 +16,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Logs/Logs.h"
 #include "Mona/Util/Util.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -26,6 +27,8 @@ mutex					Logs::_Mutex;
 
 thread_local bool		Logs::_Dumping(false);
 thread_local bool		Logs::_Logging(false);
+thread_local uint32_t	Logs::_LogThread(0);
+thread_local int64_t	Logs::_LogTime(0);
 
 volatile bool			Logs::_Dump;
 std::string				Logs::_DumpFilter;
@@ -38,6 +41,249 @@ Logs::Loggers			Logs::_Loggers;
 
 std::string				Logs::_Critic;
 
+atomic<bool>			Logs::_Async(false);
+atomic<uint64_t>		Logs::_Lost(0);
+
+struct Logs::Backend : Thread, virtual Object {
+	/*!
+	Ring buffer of one producer thread, single producer (the thread) single consumer (the backend) */
+	struct Ring : virtual Object {
+		struct Record {
+			int64_t		time;
+			const char*	file; // __FILE__, static
+			long		line;
+			uint32_t	size; // message size following the record
+			LOG_LEVEL	level;
+		};
+
+		Ring(uint32_t capacity) : thread(Thread::CurrentId()), orphan(false), pNext(NULL), _capacity(capacity), _data(new char[capacity]), _head(0), _tail(0) {}
+		~Ring() { delete[] _data; }
+
+		const uint32_t		thread;
+		std::atomic<bool>	orphan; // producer thread ended
+		Ring*				pNext;
+
+		/*!
+		Returns false if not enough space */
+		bool push(const Record& record, const char* message) {
+			uint32_t size(sizeof(Record) + record.size);
+			uint64_t head(_head.load(memory_order_relaxed));
+			if ((head - _tail.load(memory_order_acquire)) > (_capacity - size))
+				return false;
+			copy(head, (const char*)&record, sizeof(Record));
+			copy(head + sizeof(Record), message, record.size);
+			_head.store(head + size, memory_order_release);
+			return true;
+		}
+		/*!
+		Read all the records pushed, and returns records count */
+		template<typename OnRecord>
+		uint32_t pop(const OnRecord& onRecord) {
+			uint64_t tail(_tail.load(memory_order_relaxed));
+			uint64_t head(_head.load(memory_order_acquire));
+			uint32_t count(0);
+			Record record;
+			while (tail < head) {
+				read(tail, (char*)&record, sizeof(Record));
+				tail += sizeof(Record);
+				read(tail, onRecord(record, thread), record.size);
+				tail += record.size;
+				++count;
+			}
+			_tail.store(tail, memory_order_release);
+			return count;
+		}
+		uint32_t capacity() const { return _capacity; }
+	private:
+		void copy(uint64_t position, const char* data, uint32_t size) {
+			uint32_t offset(position & (_capacity - 1));
+			uint32_t first(min(size, _capacity - offset));
+			memcpy(_data + offset, data, first);
+			memcpy(_data, data + first, size - first);
+		}
+		void read(uint64_t position, char* data, uint32_t size) const {
+			uint32_t offset(position & (_capacity - 1));
+			uint32_t first(min(size, _capacity - offset));
+			memcpy(data, _data + offset, first);
+			memcpy(data + first, _data, size - first);
+		}
+
+		const uint32_t			_capacity; // power of 2
+		char*					_data;
+		std::atomic<uint64_t>	_head;
+		std::atomic<uint64_t>	_tail;
+	};
+
+	Backend() : overflow(OVERFLOW_COUNT), bufferSize(0x10000), _pRings(NULL), _reported(0), _requested(0), _flushed(0), _stopping(false) {}
+	~Backend() {
+		_Async = false;
+		stop();
+		drain(); // last logs pushed
+	}
+
+	std::atomic<Overflow>	overflow;
+	std::atomic<uint32_t>	bufferSize;
+
+	const std::string& name() const { static const std::string Name("Logs"); return Name; }
+
+	Ring& ring() {
+		struct Holder {
+			~Holder() { if (pRing) pRing->orphan = true; } // deleted by backend once empty
+			Ring* pRing;
+		};
+		thread_local Holder Local = { NULL };
+		if (!Local.pRing) {
+			uint32_t capacity(0x400);
+			while (capacity < bufferSize)
+				capacity <<= 1;
+			Local.pRing = new Ring(capacity);
+			Local.pRing->pNext = _pRings.load(memory_order_relaxed);
+			while (!_pRings.compare_exchange_weak(Local.pRing->pNext, Local.pRing, memory_order_release, memory_order_relaxed));
+		}
+		return *Local.pRing;
+	}
+	void signal() { wakeUp.set(); }
+	void flush() {
+		unique_lock<mutex> lock(_mutex);
+		if (!running() || _stopping)
+			return;
+		uint64_t request(++_requested);
+		wakeUp.set();
+		_flushedCondition.wait(lock, [this, request]() { return _flushed >= request || _stopping; });
+	}
+
+private:
+	bool run(Exception& ex, const volatile bool& requestStop) {
+		Logs::Disable disable; // no log recursion
+		{
+			lock_guard<mutex> lock(_mutex);
+			_stopping = false;
+		}
+		uint64_t requested;
+		do {
+			{
+				lock_guard<mutex> lock(_mutex);
+				requested = _requested;
+			}
+			drain();
+			unique_lock<mutex> lock(_mutex);
+			_flushed = requested;
+			_flushedCondition.notify_all();
+			if (_requested != requested)
+				continue; // new flush request
+			lock.unlock();
+			wakeUp.wait();
+		} while (!requestStop);
+		lock_guard<mutex> lock(_mutex);
+		_stopping = true; // release flush callers, remaining logs are drained by the destructor
+		_flushedCondition.notify_all();
+		return true;
+	}
+
+	struct Entry {
+		Entry(const Ring::Record& record, uint32_t thread, uint32_t offset) : time(record.time), file(record.file), line(record.line), level(record.level), thread(thread), offset(offset), size(record.size) {}
+		bool operator<(const Entry& other) const { return time < other.time; }
+		int64_t		time;
+		const char*	file;
+		long		line;
+		LOG_LEVEL	level;
+		uint32_t	thread;
+		uint32_t	offset;
+		uint32_t	size;
+	};
+	void drain() {
+		// read all the rings, and remove rings of ended threads
+		Ring* pPrevious(NULL);
+		Ring* pRing(_pRings.load(memory_order_acquire));
+		while (pRing) {
+			bool orphan(pRing->orphan.load(memory_order_acquire));
+			pRing->pop([this](const Ring::Record& record, uint32_t thread) {
+				_entries.emplace_back(record, thread, _messages.size());
+				_messages.resize(_messages.size() + record.size);
+				return &_messages[_entries.back().offset];
+			});
+			Ring* pNext(pRing->pNext);
+			if (orphan) {
+				Ring* pExpected(pRing);
+				if (pPrevious)
+					pPrevious->pNext = pNext;
+				else if (!_pRings.compare_exchange_strong(pExpected, pNext)) {
+					pPrevious = pRing; // new rings inserted before, will be removed on next drain
+					pRing = pNext;
+					continue;
+				}
+				delete pRing;
+			} else
+				pPrevious = pRing;
+			pRing = pNext;
+		}
+		uint64_t lost(_Lost.load(memory_order_relaxed));
+		if (_entries.empty() && lost == _reported)
+			return;
+		// sort by time (order of each thread preserved), and dispatch
+		stable_sort(_entries.begin(), _entries.end());
+		static Path File;
+		lock_guard<mutex> lock(Logs::_Mutex);
+		for (const Entry& entry : _entries) {
+			File.set(entry.file);
+			_LogThread = entry.thread;
+			_LogTime = entry.time;
+			bool decoded(false);
+			for (auto& it : _Loggers) {
+				if (!*it.second)
+					continue;
+				bool success;
+				if (it.second->binary())
+					success = it.second->logBinary(entry.level, File, entry.line, Packet(_messages.data() + entry.offset, entry.size));
+				else {
+					if (!decoded) {
+						_message.clear();
+						BinaryLog::Decode(_messages.data() + entry.offset, entry.size, _message);
+						decoded = true;
+					}
+					success = it.second->log(entry.level, File, entry.line, _message);
+				}
+				if (!success)
+					_Loggers.fail(*it.second);
+			}
+		}
+		_LogThread = 0;
+		_LogTime = 0;
+		if (lost > _reported && overflow == OVERFLOW_COUNT) { // OVERFLOW_DROP is silent
+			String::Assign(_message, lost - _reported, " logs lost, asynchronous logs buffer full");
+			File.set(__FILE__);
+			for (auto& it : _Loggers) {
+				if (*it.second && !(it.second->binary() ? it.second->logBinary(LOG_WARN, File, __LINE__, Encode(_message)) : it.second->log(LOG_WARN, File, __LINE__, _message)))
+					_Loggers.fail(*it.second);
+			}
+		}
+		_reported = lost;
+		_Loggers.flush();
+		_entries.clear();
+		_messages.clear();
+		if (_messages.capacity() > 0x100000) { // release memory after a burst
+			_messages.shrink_to_fit();
+			_entries.shrink_to_fit();
+		}
+	}
+
+	std::atomic<Ring*>		_pRings;
+	std::vector<Entry>		_entries;
+	std::vector<char>		_messages;
+	std::string				_message;
+	uint64_t				_reported;
+
+	std::mutex				_mutex;
+	std::condition_variable	_flushedCondition;
+	uint64_t				_requested;
+	uint64_t				_flushed;
+	bool					_stopping;
+};
+Logs::Backend& Logs::GetBackend() {
+	static Logs::Backend Backend; // built after _Loggers to be destroyed before
+	return Backend;
+}
+
 Logs::Disable::Disable(bool log, bool dump) : _logging(_Logging), _dumping(_Dumping) {
 	if (!log)
 		_Logging = true;
@@ -49,6 +295,66 @@ Logs::Disable::~Disable() {
 	_Dumping = _dumping;
 }
 
+void Logs::SetAsync(bool async, Overflow overflow, uint32_t bufferSize) {
+	GetBackend().overflow = overflow;
+	GetBackend().bufferSize = bufferSize;
+	if (async) {
+		GetBackend().start(Thread::PRIORITY_LOW);
+		_Async = true;
+		return;
+	}
+	_Async = false;
+	Flush();
+}
+
+void Logs::Flush() {
+	GetBackend().flush();
+}
+
+Packet Logs::Encode(const string& message) {
+	static Buffer Buffer; // protected by _Mutex
+	BinaryLog::Encode(Buffer.clear(), message);
+	return Packet(Buffer.data(), Buffer.size());
+}
+
+void Logs::Push(LOG_LEVEL level, const char* file, long line, const Buffer& arguments) {
+	Backend::Ring& ring(GetBackend().ring());
+	Backend::Ring::Record record;
+	record.time = Time::Now();
+	record.file = file;
+	record.line = line;
+	record.level = level;
+	record.size = arguments.size();
+	const char* data(arguments.data());
+	string message;
+	if (level <= LOG_CRITIC || record.size > (ring.capacity() - sizeof(Backend::Ring::Record)))
+		BinaryLog::Decode(arguments.data(), arguments.size(), message);
+	Buffer truncated;
+	if (record.size > (ring.capacity() - sizeof(Backend::Ring::Record))) {
+		// too big, truncate the text to keep valid arguments
+		message.resize(ring.capacity() - sizeof(Backend::Ring::Record) - 16);
+		BinaryLog::Encode(truncated, message);
+		data = truncated.data();
+		record.size = truncated.size();
+	}
+	while (!ring.push(record, data)) {
+		if (GetBackend().overflow != OVERFLOW_BLOCK || !Async()) {
+			_Lost.fetch_add(1, memory_order_relaxed);
+			break;
+		}
+		GetBackend().signal();
+		this_thread::yield();
+	}
+	GetBackend().signal();
+	if (level > LOG_CRITIC)
+		return;
+	{
+		lock_guard<mutex> lock(_Mutex);
+		_Critic.assign(message.empty() ? "unknown" : message.c_str());
+	}
+	GetBackend().flush();
+}
+
 bool Logs::LastCritic(string& critic) {
 	lock_guard<mutex> lock(_Mutex);
 	if (_Critic.empty())
@@ -18,6 +18,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Logs/ConsoleLogger.h"
+#include "Mona/Logs/BinaryLog.h"
 #include "Mona/Format/String.h"
 #include "Mona/Threading/Thread.h"
 #include <atomic>
@@ -65,6 +66,28 @@ struct Logs : virtual Static {
 	static void			SetDump(const char* name); // if null, no dump, otherwise dump name, and if name is empty everything is dumped
 	static const char*	GetDump();
 
+	enum Overflow {
+		OVERFLOW_DROP = 0, // log lost silently
+		OVERFLOW_COUNT, // log lost, a warning reports the count of lost logs on next dispatching
+		OVERFLOW_BLOCK // caller waits that the backend frees space
+	};
+	/*!
+	Asynchronous logging, the caller encodes the log arguments (BinaryLog, formatting deferred) in a thread ring buffer
+	(of bufferSize bytes, applied to new threads) and a backend thread formats and dispatches by batch to the loggers. FATAL and CRITIC logs are flushed before to return.
+	Dumps stay synchronous */
+	static void			SetAsync(bool async, Overflow overflow = OVERFLOW_COUNT, uint32_t bufferSize = 0x10000);
+	static bool			Async() { return _Async.load(std::memory_order_relaxed); }
+	/*!
+	Wait that all the asynchronous logs be dispatched to the loggers */
+	static void			Flush();
+	/*!
+	Count of asynchronous logs lost on buffer overflow */
+	static uint64_t		Lost() { return _Lost.load(std::memory_order_relaxed); }
+	/*!
+	Thread id and time of the log in dispatching, to use in a Logger rather than the current ones which are the backend ones on asynchronous logging */
+	static uint32_t		LogThread() { return _LogThread ? _LogThread : Thread::CurrentId(); }
+	static int64_t		LogTime() { return _LogTime ? _LogTime : Time::Now(); }
+
 	static bool			Dumping() { return _Dumping; }
 	static bool			Logging() { return _Logging; }
 	
@@ -75,6 +98,14 @@ struct Logs : virtual Static {
 		if (_Logging || _Level < level)
 			return;
 		_Logging = true;
+		if (Async()) {
+			// deferred formatting, arguments are encoded and formatted by the backend thread
+			thread_local Buffer Arguments;
+			BinaryLog::Encode(Arguments.clear(), std::forward<Args>(args)...);
+			Push(level, file, line, Arguments);
+			_Logging = false;
+			return;
+		}
 		std::lock_guard<std::mutex> lock(_Mutex);
 		static Path File;
 		static String Message;
@@ -83,7 +114,7 @@ struct Logs : virtual Static {
 		if (level <= LOG_CRITIC)
 			_Critic.assign(Message.empty() ? "unknown" : Message.c_str());
 		for (auto& it : _Loggers) {
-			if (*it.second && !it.second->log(level, File, line, Message))
+			if (*it.second && !(it.second->binary() ? it.second->logBinary(level, File, line, Encode(Message)) : it.second->log(level, File, line, Message)))
 				_Loggers.fail(*it.second);
 		}
 		if(Message.size()>0xFF) {
@@ -145,12 +176,24 @@ struct Logs : virtual Static {
 
 private:
 	static void		Dump(const std::string& header, const char* data, uint32_t size);
+	static void		Push(LOG_LEVEL level, const char* file, long line, const Buffer& arguments);
+	/*!
+	Message encoded as one BinaryLog string argument, for binary loggers */
+	static Packet	Encode(const std::string& message);
+
+	struct Backend;
+	static Backend&	GetBackend();
 
 	static std::mutex				_Mutex;
 	static std::string				_Critic;
 
 	static thread_local bool		_Logging;
 	static thread_local bool		_Dumping;
+	static thread_local uint32_t	_LogThread;
+	static thread_local int64_t		_LogTime;
+
+	static std::atomic<bool>		_Async;
+	static std::atomic<uint64_t>	_Lost;
 
 	static std::atomic<LOG_LEVEL>	_Level;
 	static struct Loggers : std::map<std::string, Unique<Logger>, String::IComparator>, virtual Object {
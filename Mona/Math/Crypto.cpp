@@ -15,6 +15,17 @@ details (or else see http://mozilla.org/MPL/2.0/).
 */
 
 #include "Mona/Math/Crypto.h"
+#include "Mona/Util/CPU.h"
+#include <algorithm>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	#include OpenSSL(core_names.h)
+#endif
+#if defined(_X86)
+	#include <immintrin.h>
+	#include <wmmintrin.h>
+#elif defined(_ARM64) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+	#include <arm_neon.h>
+#endif
 
 using namespace std;
 
@@ -34,6 +45,27 @@ static void HMAC_CTX_free(HMAC_CTX* ctx) {
 #define EVP_MD_CTX_free EVP_MD_CTX_destroy
 #endif
 
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+/*!
+EVP_MAC replaces HMAC_* functions, digest is given by name so set just when it changes (evp=NULL), key=NULL restarts with the same key */
+static EVP_MAC_CTX* HMAC_CTX_new() {
+	static EVP_MAC* PMAC(EVP_MAC_fetch(NULL, "HMAC", NULL)); // fetched once
+	return EVP_MAC_CTX_new(PMAC);
+}
+static void HMAC_CTX_free(EVP_MAC_CTX* ctx) { EVP_MAC_CTX_free(ctx); }
+static int HMAC_Init_ex(EVP_MAC_CTX* ctx, const void* key, int keySize, const EVP_MD* evp, ENGINE*) {
+	if (!evp)
+		return EVP_MAC_init(ctx, BIN key, keySize, NULL);
+	OSSL_PARAM params[] = { OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, (char*)EVP_MD_get0_name(evp), 0), OSSL_PARAM_construct_end() };
+	return EVP_MAC_init(ctx, BIN key, keySize, params);
+}
+static int HMAC_Update(EVP_MAC_CTX* ctx, const unsigned char* data, size_t size) { return EVP_MAC_update(ctx, data, size); }
+static int HMAC_Final(EVP_MAC_CTX* ctx, unsigned char* value, unsigned int*) {
+	size_t size;
+	return EVP_MAC_final(ctx, value, &size, EVP_MAX_MD_SIZE);
+}
+#endif
+
 uint8_t  Crypto::Rotate8(uint8_t value) {
 	value = ((value >> 1) & 0x5555) | ((value & 0x5555) << 1);
 	value = ((value >> 2) & 0x3333) | ((value & 0x3333) << 2);
@@ -67,102 +99,260 @@ uint64_t Crypto::Rotate64(uint64_t value) {
 	return (value >> 32) | (value << 32);
 }
 
+Crypto::Hash::Context::Context(const EVP_MD* evp) : _evp(evp), _ctx(EVP_MD_CTX_new()), _restart(true) {
+}
+Crypto::Hash::Context::~Context() {
+	EVP_MD_CTX_free(_ctx);
+}
+Crypto::Hash::Context& Crypto::Hash::Context::init(const EVP_MD* evp) {
+	if (evp)
+		_evp = evp;
+	_restart = true;
+	return self;
+}
+void Crypto::Hash::Context::onUpdate(const void* data, uint32_t size) {
+	if (_restart) {
+		EVP_DigestInit_ex(_ctx, _evp, NULL);
+		_restart = false;
+	}
+	EVP_DigestUpdate(_ctx, data, size);
+}
+char* Crypto::Hash::Context::final(char* value) {
+	if (_restart)
+		EVP_DigestInit_ex(_ctx, _evp, NULL);
+	EVP_DigestFinal_ex(_ctx, BIN value, NULL);
+	_restart = true;
+	return value;
+}
+
 char* Crypto::Hash::Compute(const EVP_MD* evp, const char* data, uint32_t size, char* value) {
-	thread_local struct CTX {
-		CTX() : _ctx(EVP_MD_CTX_new()) {}
-		~CTX() { EVP_MD_CTX_free(_ctx); }
-		EVP_MD_CTX*	operator&() { return _ctx; }
-	private:
-		EVP_MD_CTX* _ctx;
-	} CTX;
-	EVP_DigestInit_ex(&CTX, evp, NULL);
-	EVP_DigestUpdate(&CTX, data, size);
-	EVP_DigestFinal_ex(&CTX, BIN value, NULL);
+	thread_local Context Context(evp);
+	return Context.init(evp).update(data, size).final(value);
+}
+
+Crypto::HMAC::Context::Context(const EVP_MD* evp, const char* key, int keySize) : _evp(evp), _ctx(HMAC_CTX_new()), _restart(false) {
+	HMAC_Init_ex(_ctx, key, keySize, _evp, NULL);
+}
+Crypto::HMAC::Context::~Context() {
+	HMAC_CTX_free(_ctx);
+}
+Crypto::HMAC::Context& Crypto::HMAC::Context::init(const EVP_MD* evp, const char* key, int keySize) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	HMAC_Init_ex(_ctx, key, keySize, evp == _evp ? NULL : evp, NULL); // digest fetched by name just if changed
+	_evp = evp;
+#else
+	HMAC_Init_ex(_ctx, key, keySize, _evp = evp, NULL);
+#endif
+	_restart = false;
+	return self;
+}
+void Crypto::HMAC::Context::onUpdate(const void* data, uint32_t size) {
+	if (_restart) {
+		HMAC_Init_ex(_ctx, NULL, 0, NULL, NULL); // same key and algorithm
+		_restart = false;
+	}
+	HMAC_Update(_ctx, BIN data, size);
+}
+char* Crypto::HMAC::Context::final(char* value) {
+	if (_restart)
+		HMAC_Init_ex(_ctx, NULL, 0, NULL, NULL);
+	HMAC_Final(_ctx, BIN value, NULL);
+	_restart = true;
 	return value;
 }
 
 char* Crypto::HMAC::Compute(const EVP_MD* evp, const char* key, int keySize, const char* data, uint32_t size, char* value) {
-	thread_local struct CTX {
-		CTX() : _ctx(HMAC_CTX_new()) {}
-		~CTX() { HMAC_CTX_free(_ctx); }
-		HMAC_CTX* operator&() { return _ctx; }
-	private:
-		HMAC_CTX* _ctx;
-	} CTX;
-	HMAC_Init_ex(&CTX, key, keySize, evp, NULL);
-	HMAC_Update(&CTX, BIN data, size);
-	HMAC_Final(&CTX, BIN value, NULL);
-	return value;
+	thread_local Context Context(evp, key, keySize);
+	return Context.init(evp, key, keySize).update(data, size).final(value);
+}
+
+uint16_t Crypto::ComputeChecksum(const char* data, uint32_t size, Bytes::Order byteOrder) {
+	// One's complement sum doesn't depend on byte order (RFC 1071), so sum native 32-bit words in a 64-bit accumulator
+	// (no carry possible for less than 4GB), fold it to 16 bits and flip it if words have not the native order
+	const uint8_t* bytes(BIN data);
+	uint64_t sum = 0;
+	for (; size >= 16; size -= 16, bytes += 16) {
+		uint64_t words[2];
+		memcpy(words, bytes, sizeof(words));
+		sum += (words[0] & 0xFFFFFFFF) + (words[0] >> 32) + (words[1] & 0xFFFFFFFF) + (words[1] >> 32);
+	}
+	for (; size >= 2; size -= 2, bytes += 2) {
+		uint16_t word;
+		memcpy(&word, bytes, sizeof(word));
+		sum += word;
+	}
+	while (sum >> 16)
+		sum = (sum >> 16) + (sum & 0xFFFF);
+	if (byteOrder != Bytes::ORDER_NATIVE)
+		sum = Bytes::Flip16(uint16_t(sum));
+	if (size) {
+		sum += *bytes;
+		sum = (sum >> 16) + (sum & 0xFFFF);
+	}
+	return ~uint16_t(sum);
 }
 
-uint16_t Crypto::ComputeChecksum(BinaryReader& reader) {
-	uint32_t sum = 0;
-	uint32_t pos(reader.position());
-	while(reader.available()>0)
-		sum += reader.available()==1 ? reader.read8() : reader.read16();
-	reader.reset(pos);
 
-  /* add back carry outs from top 16 bits to low 16 bits */
-  sum = (sum >> 16) + (sum & 0xffff);     /* add hi 16 to low 16 */
-  sum += (sum >> 16);                     /* add carry */
-  return ~sum; /* truncate to 16 bits */
+/*!
+Slicing-by-8 tables, [N][byte] = CRC of byte followed by N zero bytes.
+"reflected" is the LSB-first variant (polynomial 0xEDB88320), equivalent to the MSB-first CRC on bit-reversed bytes */
+struct CRC32Tables : virtual Object {
+	CRC32Tables() {
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t crc = i << 24;
+			for (uint8_t bit = 0; bit < 8; ++bit)
+				crc = (crc << 1) ^ (0x04C11DB7 & (0 - (crc >> 31)));
+			normal[0][i] = crc;
+			crc = i;
+			for (uint8_t bit = 0; bit < 8; ++bit)
+				crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+			reflected[0][i] = crc;
+		}
+		for (uint32_t i = 0; i < 256; ++i) {
+			for (uint8_t n = 1; n < 8; ++n) {
+				normal[n][i] = (normal[n - 1][i] << 8) ^ normal[0][normal[n - 1][i] >> 24];
+				reflected[n][i] = (reflected[n - 1][i] >> 8) ^ reflected[0][reflected[n - 1][i] & 0xFF];
+			}
+		}
+	}
+	uint32_t normal[8][256];
+	uint32_t reflected[8][256];
+
+	uint32_t computeNormal(uint32_t crc, const uint8_t* data, uint32_t size) const {
+		for (; size >= 8; size -= 8, data += 8) {
+			crc ^= (data[0] << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+			crc = normal[7][crc >> 24] ^ normal[6][(crc >> 16) & 0xFF] ^ normal[5][(crc >> 8) & 0xFF] ^ normal[4][crc & 0xFF] ^
+				normal[3][data[4]] ^ normal[2][data[5]] ^ normal[1][data[6]] ^ normal[0][data[7]];
+		}
+		while (size--)
+			crc = (crc << 8) ^ normal[0][(crc >> 24) ^ *data++];
+		return crc;
+	}
+	uint32_t computeReflected(uint32_t crc, const uint8_t* data, uint32_t size) const {
+		for (; size >= 8; size -= 8, data += 8) {
+			crc ^= data[0] | (data[1] << 8) | (data[2] << 16) | (uint32_t(data[3]) << 24);
+			crc = reflected[7][crc & 0xFF] ^ reflected[6][(crc >> 8) & 0xFF] ^ reflected[5][(crc >> 16) & 0xFF] ^ reflected[4][crc >> 24] ^
+				reflected[3][data[4]] ^ reflected[2][data[5]] ^ reflected[1][data[6]] ^ reflected[0][data[7]];
+		}
+		while (size--)
+			crc = (crc >> 8) ^ reflected[0][(crc ^ *data++) & 0xFF];
+		return crc;
+	}
+};
+static const CRC32Tables& CRC32() {
+	static const CRC32Tables Tables;
+	return Tables;
 }
 
+/*
+Folding by carry-less multiplication (Intel "Fast CRC Computation Using PCLMULQDQ Instruction"): 4 lanes of 16 bytes
+are folded 64 bytes further while data remain, then folded in one lane which is reduced by table.
+MSB-first CRC loads bytes reversed (first byte = highest degree) and folds with x^576, x^512, x^192 and x^128 mod P,
+reflected CRC loads bytes as is and folds with x^544, x^480, x^160 and x^96 mod P bit-reflected and shifted by one */
+enum {
+	CRC32_FOLD_MIN = 128
+};
+#if defined(_X86)
+template<bool NORMAL>
+static TARGET("ssse3") __m128i LoadCRC32(const uint8_t* data) {
+	__m128i value = _mm_loadu_si128((const __m128i*)data);
+	return NORMAL ? _mm_shuffle_epi8(value, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)) : value;
+}
+static TARGET("pclmul") __m128i FoldCRC32(__m128i value, __m128i constants, __m128i data) {
+	return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(value, constants, 0x00), _mm_clmulepi64_si128(value, constants, 0x11)), data);
+}
+template<bool NORMAL>
+static TARGET("pclmul,ssse3") uint32_t FoldCRC32(uint32_t crc, const uint8_t*& data, uint32_t& size) {
+	__m128i lane0 = _mm_xor_si128(LoadCRC32<NORMAL>(data), NORMAL ? _mm_set_epi32(crc, 0, 0, 0) : _mm_cvtsi32_si128(crc));
+	__m128i lane1 = LoadCRC32<NORMAL>(data + 16);
+	__m128i lane2 = LoadCRC32<NORMAL>(data + 32);
+	__m128i lane3 = LoadCRC32<NORMAL>(data + 48);
+	for (data += 64, size -= 64; size >= 64; data += 64, size -= 64) {
+		const __m128i constants = NORMAL ? _mm_set_epi64x(0x8833794C, 0xE6228B11) : _mm_set_epi64x(0x1C6E41596, 0x154442BD4);
+		lane0 = FoldCRC32(lane0, constants, LoadCRC32<NORMAL>(data));
+		lane1 = FoldCRC32(lane1, constants, LoadCRC32<NORMAL>(data + 16));
+		lane2 = FoldCRC32(lane2, constants, LoadCRC32<NORMAL>(data + 32));
+		lane3 = FoldCRC32(lane3, constants, LoadCRC32<NORMAL>(data + 48));
+	}
+	const __m128i constants = NORMAL ? _mm_set_epi64x(0xC5B9CD4C, 0xE8A45605) : _mm_set_epi64x(0x0CCAA009E, 0x1751997D0);
+	lane0 = FoldCRC32(FoldCRC32(FoldCRC32(lane0, constants, lane1), constants, lane2), constants, lane3);
+	for (; size >= 16; data += 16, size -= 16)
+		lane0 = FoldCRC32(lane0, constants, LoadCRC32<NORMAL>(data));
+	uint8_t bytes[16];
+	_mm_storeu_si128((__m128i*)bytes, lane0);
+	if (!NORMAL)
+		return CRC32().computeReflected(0, bytes, sizeof(bytes));
+	std::reverse(bytes, bytes + sizeof(bytes));
+	return CRC32().computeNormal(0, bytes, sizeof(bytes));
+}
+static bool FoldCRC32(uint32_t& crc, const uint8_t*& data, uint32_t& size, bool normal) {
+	if (size < CRC32_FOLD_MIN || !CPU::Has(CPU::FEATURE_PCLMUL | CPU::FEATURE_SSSE3))
+		return false;
+	crc = normal ? FoldCRC32<true>(crc, data, size) : FoldCRC32<false>(crc, data, size);
+	return true;
+}
+#elif defined(_ARM64) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+template<bool NORMAL>
+static uint64x2_t LoadCRC32(const uint8_t* data) {
+	uint8x16_t value = vld1q_u8(data);
+	if (NORMAL) {
+		value = vrev64q_u8(value);
+		value = vextq_u8(value, value, 8);
+	}
+	return vreinterpretq_u64_u8(value);
+}
+static uint64x2_t FoldCRC32(uint64x2_t value, uint64x2_t constants, uint64x2_t data) {
+	uint64x2_t low = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(value, 0), (poly64_t)vgetq_lane_u64(constants, 0)));
+	uint64x2_t high = vreinterpretq_u64_p128(vmull_p64((poly64_t)vgetq_lane_u64(value, 1), (poly64_t)vgetq_lane_u64(constants, 1)));
+	return veorq_u64(veorq_u64(low, high), data);
+}
+static uint64x2_t ConstantsCRC32(uint64_t low, uint64_t high) { return vcombine_u64(vcreate_u64(low), vcreate_u64(high)); }
+template<bool NORMAL>
+static uint32_t FoldCRC32(uint32_t crc, const uint8_t*& data, uint32_t& size) {
+	uint64x2_t lane0 = veorq_u64(LoadCRC32<NORMAL>(data), NORMAL ? ConstantsCRC32(0, uint64_t(crc) << 32) : ConstantsCRC32(crc, 0));
+	uint64x2_t lane1 = LoadCRC32<NORMAL>(data + 16);
+	uint64x2_t lane2 = LoadCRC32<NORMAL>(data + 32);
+	uint64x2_t lane3 = LoadCRC32<NORMAL>(data + 48);
+	for (data += 64, size -= 64; size >= 64; data += 64, size -= 64) {
+		const uint64x2_t constants = NORMAL ? ConstantsCRC32(0xE6228B11, 0x8833794C) : ConstantsCRC32(0x154442BD4, 0x1C6E41596);
+		lane0 = FoldCRC32(lane0, constants, LoadCRC32<NORMAL>(data));
+		lane1 = FoldCRC32(lane1, constants, LoadCRC32<NORMAL>(data + 16));
+		lane2 = FoldCRC32(lane2, constants, LoadCRC32<NORMAL>(data + 32));
+		lane3 = FoldCRC32(lane3, constants, LoadCRC32<NORMAL>(data + 48));
+	}
+	const uint64x2_t constants = NORMAL ? ConstantsCRC32(0xE8A45605, 0xC5B9CD4C) : ConstantsCRC32(0x1751997D0, 0x0CCAA009E);
+	lane0 = FoldCRC32(FoldCRC32(FoldCRC32(lane0, constants, lane1), constants, lane2), constants, lane3);
+	for (; size >= 16; data += 16, size -= 16)
+		lane0 = FoldCRC32(lane0, constants, LoadCRC32<NORMAL>(data));
+	uint8_t bytes[16];
+	vst1q_u8(bytes, vreinterpretq_u8_u64(lane0));
+	if (!NORMAL)
+		return CRC32().computeReflected(0, bytes, sizeof(bytes));
+	std::reverse(bytes, bytes + sizeof(bytes));
+	return CRC32().computeNormal(0, bytes, sizeof(bytes));
+}
+static bool FoldCRC32(uint32_t& crc, const uint8_t*& data, uint32_t& size, bool normal) {
+	if (size < CRC32_FOLD_MIN || !CPU::Has(CPU::FEATURE_PMULL))
+		return false;
+	crc = normal ? FoldCRC32<true>(crc, data, size) : FoldCRC32<false>(crc, data, size);
+	return true;
+}
+#else
+static bool FoldCRC32(uint32_t& crc, const uint8_t*& data, uint32_t& size, bool normal) { return false; }
+#endif
 
 uint32_t Crypto::ComputeCRC32(const char* data, uint32_t size, ROTATE_OPTIONS options) {
-	static const uint32_t CRC32[256] = {
-	   0x00000000, 0x04c11db7, 0x09823b6e, 0x0d4326d9, 0x130476dc, 0x17c56b6b,
-	   0x1a864db2, 0x1e475005, 0x2608edb8, 0x22c9f00f, 0x2f8ad6d6, 0x2b4bcb61,
-	   0x350c9b64, 0x31cd86d3, 0x3c8ea00a, 0x384fbdbd, 0x4c11db70, 0x48d0c6c7,
-	   0x4593e01e, 0x4152fda9, 0x5f15adac, 0x5bd4b01b, 0x569796c2, 0x52568b75,
-	   0x6a1936c8, 0x6ed82b7f, 0x639b0da6, 0x675a1011, 0x791d4014, 0x7ddc5da3,
-	   0x709f7b7a, 0x745e66cd, 0x9823b6e0, 0x9ce2ab57, 0x91a18d8e, 0x95609039,
-	   0x8b27c03c, 0x8fe6dd8b, 0x82a5fb52, 0x8664e6e5, 0xbe2b5b58, 0xbaea46ef,
-	   0xb7a96036, 0xb3687d81, 0xad2f2d84, 0xa9ee3033, 0xa4ad16ea, 0xa06c0b5d,
-	   0xd4326d90, 0xd0f37027, 0xddb056fe, 0xd9714b49, 0xc7361b4c, 0xc3f706fb,
-	   0xceb42022, 0xca753d95, 0xf23a8028, 0xf6fb9d9f, 0xfbb8bb46, 0xff79a6f1,
-	   0xe13ef6f4, 0xe5ffeb43, 0xe8bccd9a, 0xec7dd02d, 0x34867077, 0x30476dc0,
-	   0x3d044b19, 0x39c556ae, 0x278206ab, 0x23431b1c, 0x2e003dc5, 0x2ac12072,
-	   0x128e9dcf, 0x164f8078, 0x1b0ca6a1, 0x1fcdbb16, 0x018aeb13, 0x054bf6a4,
-	   0x0808d07d, 0x0cc9cdca, 0x7897ab07, 0x7c56b6b0, 0x71159069, 0x75d48dde,
-	   0x6b93dddb, 0x6f52c06c, 0x6211e6b5, 0x66d0fb02, 0x5e9f46bf, 0x5a5e5b08,
-	   0x571d7dd1, 0x53dc6066, 0x4d9b3063, 0x495a2dd4, 0x44190b0d, 0x40d816ba,
-	   0xaca5c697, 0xa864db20, 0xa527fdf9, 0xa1e6e04e, 0xbfa1b04b, 0xbb60adfc,
-	   0xb6238b25, 0xb2e29692, 0x8aad2b2f, 0x8e6c3698, 0x832f1041, 0x87ee0df6,
-	   0x99a95df3, 0x9d684044, 0x902b669d, 0x94ea7b2a, 0xe0b41de7, 0xe4750050,
-	   0xe9362689, 0xedf73b3e, 0xf3b06b3b, 0xf771768c, 0xfa325055, 0xfef34de2,
-	   0xc6bcf05f, 0xc27dede8, 0xcf3ecb31, 0xcbffd686, 0xd5b88683, 0xd1799b34,
-	   0xdc3abded, 0xd8fba05a, 0x690ce0ee, 0x6dcdfd59, 0x608edb80, 0x644fc637,
-	   0x7a089632, 0x7ec98b85, 0x738aad5c, 0x774bb0eb, 0x4f040d56, 0x4bc510e1,
-	   0x46863638, 0x42472b8f, 0x5c007b8a, 0x58c1663d, 0x558240e4, 0x51435d53,
-	   0x251d3b9e, 0x21dc2629, 0x2c9f00f0, 0x285e1d47, 0x36194d42, 0x32d850f5,
-	   0x3f9b762c, 0x3b5a6b9b, 0x0315d626, 0x07d4cb91, 0x0a97ed48, 0x0e56f0ff,
-	   0x1011a0fa, 0x14d0bd4d, 0x19939b94, 0x1d528623, 0xf12f560e, 0xf5ee4bb9,
-	   0xf8ad6d60, 0xfc6c70d7, 0xe22b20d2, 0xe6ea3d65, 0xeba91bbc, 0xef68060b,
-	   0xd727bbb6, 0xd3e6a601, 0xdea580d8, 0xda649d6f, 0xc423cd6a, 0xc0e2d0dd,
-	   0xcda1f604, 0xc960ebb3, 0xbd3e8d7e, 0xb9ff90c9, 0xb4bcb610, 0xb07daba7,
-	   0xae3afba2, 0xaafbe615, 0xa7b8c0cc, 0xa379dd7b, 0x9b3660c6, 0x9ff77d71,
-	   0x92b45ba8, 0x9675461f, 0x8832161a, 0x8cf30bad, 0x81b02d74, 0x857130c3,
-	   0x5d8a9099, 0x594b8d2e, 0x5408abf7, 0x50c9b640, 0x4e8ee645, 0x4a4ffbf2,
-	   0x470cdd2b, 0x43cdc09c, 0x7b827d21, 0x7f436096, 0x7200464f, 0x76c15bf8,
-	   0x68860bfd, 0x6c47164a, 0x61043093, 0x65c52d24, 0x119b4be9, 0x155a565e,
-	   0x18197087, 0x1cd86d30, 0x029f3d35, 0x065e2082, 0x0b1d065b, 0x0fdc1bec,
-	   0x3793a651, 0x3352bbe6, 0x3e119d3f, 0x3ad08088, 0x2497d08d, 0x2056cd3a,
-	   0x2d15ebe3, 0x29d4f654, 0xc5a92679, 0xc1683bce, 0xcc2b1d17, 0xc8ea00a0,
-	   0xd6ad50a5, 0xd26c4d12, 0xdf2f6bcb, 0xdbee767c, 0xe3a1cbc1, 0xe760d676,
-	   0xea23f0af, 0xeee2ed18, 0xf0a5bd1d, 0xf464a0aa, 0xf9278673, 0xfde69bc4,
-	   0x89b8fd09, 0x8d79e0be, 0x803ac667, 0x84fbdbd0, 0x9abc8bd5, 0x9e7d9662,
-	   0x933eb0bb, 0x97ffad0c, 0xafb010b1, 0xab710d06, 0xa6322bdf, 0xa2f33668,
-	   0xbcb4666d, 0xb8757bda, 0xb5365d03, 0xb1f740b4
-	};
-    uint32_t crc(0xffffffff);
-	for (uint32_t i = 0; i < size; ++i) {
-		if (options&ROTATE_INPUT)
-			crc = (crc << 8) ^ CRC32[(crc >> 24) ^ Rotate8(*data++)];
-		else
-			crc = (crc << 8) ^ CRC32[(crc >> 24) ^ uint8_t(*data++)];
+	const uint8_t* bytes(BIN data);
+	uint32_t crc(0xffffffff);
+	if (options&ROTATE_INPUT) {
+		// MSB-first CRC on bit-reversed bytes = bit-reversed LSB-first CRC on bytes
+		FoldCRC32(crc, bytes, size, false);
+		crc = Rotate32(CRC32().computeReflected(crc, bytes, size));
+	} else {
+		FoldCRC32(crc, bytes, size, true);
+		crc = CRC32().computeNormal(crc, bytes, size);
 	}
-    return options&ROTATE_OUTPUT ? Rotate32(crc) : crc;
+	return options&ROTATE_OUTPUT ? Rotate32(crc) : crc;
 }
 
 
@@ -18,6 +18,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Format/BinaryReader.h"
+#include "Mona/Memory/Rope.h"
 #include "Mona/Util/Exceptions.h"
 #include OpenSSL(hmac.h)
 #include OpenSSL(err.h)
@@ -53,11 +54,40 @@ struct Crypto : virtual Static {
 	static uint32_t Rotate32(uint32_t value);
 	static uint64_t Rotate64(uint64_t value);
 
-	static uint16_t ComputeChecksum(BinaryReader& reader);
+	/*!
+	Internet checksum (RFC 1071) of the available reader bytes, words are read with the reader byte order
+	and a last odd byte is added as a low-order byte. Reader position is unchanged */
+	static uint16_t ComputeChecksum(BinaryReader& reader) { return ComputeChecksum(reader.current(), reader.available(), reader.byteOrder()); }
+	static uint16_t ComputeChecksum(const char* data, uint32_t size, Bytes::Order byteOrder = Bytes::ORDER_NETWORK);
 
+	/*!
+	CRC-32 MSB-first (polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no final xor, CRC-32/MPEG-2),
+	ROTATE_INPUT reverses bits of every input byte and ROTATE_OUTPUT reverses bits of the result (both = ~zlib crc32).
+	Vectorized with carry-less multiplication (PCLMULQDQ or PMULL) when available, slicing-by-8 otherwise */
 	static uint32_t ComputeCRC32(const char* data, uint32_t size, ROTATE_OPTIONS options =0);
 
 
+	/*!
+	Incremental digest which accepts scatter lists: memory chunks, Bytes (Packet, Buffer...), Rope or containers of them.
+	Its OpenSSL context is allocated one time and reused, final() writes the result and restarts a new message */
+	struct Digest : virtual Object {
+		Digest&	update(const void* data, uint32_t size) { onUpdate(data, size); return self; }
+		Digest&	update(const Bytes& bytes) { onUpdate(bytes.data(), bytes.size()); return self; }
+		Digest&	update(const Rope& rope) { rope.forEach([this](const char* data, uint32_t size) { onUpdate(data, size); return true; }); return self; }
+		template<typename ListType, typename = typename std::enable_if<!std::is_base_of<Bytes, ListType>::value && !std::is_same<Rope, ListType>::value>::type>
+		Digest&	update(const ListType& list) {
+			for (const auto& chunk : list)
+				update(chunk);
+			return self;
+		}
+		/*!
+		Write the digest (size() bytes) to value and restart a new message */
+		virtual char*		final(char* value) = 0;
+		virtual uint32_t	size() const = 0;
+	private:
+		virtual void		onUpdate(const void* data, uint32_t size) = 0;
+	};
+
 	struct Hash : virtual Static {
 		static char* MD5(char* value, uint32_t size) { return Compute(EVP_md5(), value, size, value); }
 		static char* MD5(const char* data, uint32_t size, char* value) { return Compute(EVP_md5(), data, size, value); }
@@ -66,7 +96,25 @@ struct Crypto : virtual Static {
 		static char* SHA256(char* value, uint32_t size) { return Compute(EVP_sha256(), value, size, value); }
 		static char* SHA256(const char* data, uint32_t size, char* value) { return Compute(EVP_sha256(), data, size, value); }
 
+		/*!
+		One-shot hash with the preallocated context of the calling thread */
 		static char* Compute(const EVP_MD* evp, const char* data, uint32_t size, char* value);
+
+		struct Context : Digest, virtual Object {
+			Context(const EVP_MD* evp);
+			~Context();
+			/*!
+			Restart a new message, with an other algorithm if evp is not null */
+			Context&	init(const EVP_MD* evp = NULL);
+			char*		final(char* value);
+			uint32_t	size() const { return EVP_MD_size(_evp); }
+		private:
+			void		onUpdate(const void* data, uint32_t size);
+
+			const EVP_MD*	_evp;
+			EVP_MD_CTX*		_ctx;
+			bool			_restart; // initialization delayed to the first use to not initialize twice
+		};
 	};
 
 	struct HMAC : virtual Static {
@@ -77,7 +125,29 @@ struct Crypto : virtual Static {
 		static char* SHA256(const char* key, int keySize, char* value, uint32_t size) { return Compute(EVP_sha256(), key, keySize, value, size, value); }
 		static char* SHA256(const char* key, int keySize, const char* data, uint32_t size, char* value) { return Compute(EVP_sha256(), key, keySize, data, size, value); }
 
+		/*!
+		One-shot HMAC with the preallocated context of the calling thread */
 		static char* Compute(const EVP_MD* evp, const char* key, int keySize, const char* data, uint32_t size, char* value);
+
+		struct Context : Digest, virtual Object {
+			Context(const EVP_MD* evp, const char* key, int keySize);
+			~Context();
+			/*!
+			Restart a new message with an other algorithm and key (final() restarts already with the same key) */
+			Context&	init(const EVP_MD* evp, const char* key, int keySize);
+			char*		final(char* value);
+			uint32_t	size() const { return EVP_MD_size(_evp); }
+		private:
+			void		onUpdate(const void* data, uint32_t size);
+
+			const EVP_MD*	_evp;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			EVP_MAC_CTX*	_ctx; // HMAC_* functions are deprecated since OpenSSL 3
+#else
+			HMAC_CTX*		_ctx;
+#endif
+			bool			_restart;
+		};
 	};
 
 };
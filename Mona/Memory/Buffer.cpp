@@ -16,6 +16,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Memory/Buffer.h"
 #include "Mona/Util/Exceptions.h"
+#include "Mona/Logs/Logs.h"
 
 using namespace std;
 
@@ -23,44 +24,202 @@ namespace Mona {
 
 static char _Empty;
 
-char* Buffer::Allocator::Alloc(uint32_t& size) {
-	if (size<=16) { // at minimum allocate 16 bytes!
-		if (!size) {
-			Get(); // just access to Allocator to create it, to avoid a crash on static Buffer destruction with a Allocator access after deletion (see SerialisersTest for example)
-			return &_Empty;
+/*!
+Allocation counters by thread, written just by their thread (without atomic operation lock) and read by Stats,
+system allocations and releases are counted the same way to keep the hot path free of shared cache line */
+struct Counters {
+	atomic<uint64_t> allocs;
+	atomic<uint64_t> frees;
+	atomic<uint64_t> misses; // buffers allocated from system
+	atomic<uint64_t> deletes; // buffers released to system
+	atomic<uint64_t> reclaims;
+};
+struct Shard {
+	Shard(bool shared = false) : classes(), used(true), shared(shared), pNext(NULL) {}
+	Counters classes[28];
+	atomic<bool> used;
+	const bool	 shared; // written by several threads, with atomic operations
+	Shard*		 pNext;
+};
+static atomic<Shard*> _PShards(NULL); // shards are never deleted but reused when thread ends
+static thread_local Shard* _PShard(NULL); // POD for a fast access, stays readable after thread end
+
+static Shard* NewShard(bool shared = false) {
+	Shard* pShard = new Shard(shared);
+	pShard->pNext = _PShards;
+	while (!_PShards.compare_exchange_weak(pShard->pNext, pShard));
+	return pShard;
+}
+/*!
+Shard of the threads which allocate or free after the end of their thread shard (thread_local destructions) */
+static Shard* SharedShard() { static Shard* PShared(NewShard(true)); return PShared; }
+
+static Shard* AcquireShard() {
+	// release shard on thread end
+	static thread_local struct Releaser {
+		~Releaser() {
+			if (_PShard)
+				_PShard->used = false;
+			_PShard = SharedShard();
 		}
-		size = 16;
-	} else { 
-		 // fast compute the closer upper power of two for new capacity
-		uint32_t capacity = size - 1; // at minimum allocate 16 bytes!
-		capacity |= capacity >> 1;
-		capacity |= capacity >> 2;
-		capacity |= capacity >> 4;
-		capacity |= capacity >> 8;
-		capacity |= capacity >> 16;
-		if (++capacity) // if = 0 exceeds uint32_t, keep original size required
-			size = capacity;
-		if (size>0x80000000)
-			return new char[size];
+	} Releaser;
+	(void)Releaser;
+	for (Shard* pShard = _PShards; pShard; pShard = pShard->pNext) {
+		bool used(false);
+		if (pShard->used.compare_exchange_strong(used, true))
+			return _PShard = pShard;
 	}
-	if (!TryLock())
+	return _PShard = NewShard();
+}
+static uint64_t Count(atomic<uint64_t> Counters::*counter, uint8_t index) {
+	Shard* pShard = _PShard;
+	if (!pShard)
+		pShard = AcquireShard();
+	atomic<uint64_t>& value(pShard->classes[index].*counter);
+	if (pShard->shared)
+		return value.fetch_add(1, memory_order_relaxed) + 1;
+	uint64_t result = value.load(memory_order_relaxed) + 1;
+	value.store(result, memory_order_relaxed); // just one writer, no need of a locked fetch_add
+	return result;
+}
+static uint64_t Sum(atomic<uint64_t> Counters::*counter, uint8_t index) {
+	uint64_t result(0);
+	for (Shard* pShard = _PShards.load(memory_order_acquire); pShard; pShard = pShard->pNext)
+		result += (pShard->classes[index].*counter).load(memory_order_relaxed);
+	return result;
+}
+
+/*!
+High-water mark of buffers allocated from system, sampled (summing shards is too expensive for every system allocation) */
+static atomic<uint64_t> _Peaks[28];
+static uint64_t RaisePeak(uint8_t index) {
+	uint64_t misses = Sum(&Counters::misses, index);
+	uint64_t deletes = Sum(&Counters::deletes, index);
+	uint64_t count = misses > deletes ? misses - deletes : 0;
+	uint64_t peak = _Peaks[index].load(memory_order_relaxed);
+	while (count > peak && !_Peaks[index].compare_exchange_weak(peak, count, memory_order_relaxed));
+	return count;
+}
+
+char* Buffer::Allocator::New(uint32_t capacity) {
+	uint8_t index = ComputeIndex(capacity);
+	if (!(Count(&Counters::misses, index) & 63))
+		RaisePeak(index); // sample every 64 system allocations of the thread
+	return new char[capacity];
+}
+
+void Buffer::Allocator::Delete(char* buffer, uint32_t capacity, bool reclaim) {
+	uint8_t index = ComputeIndex(capacity);
+	if (reclaim) {
+		RaisePeak(index); // garbage collection is rare and decreases the footprint, sample before
+		Count(&Counters::reclaims, index);
+	}
+	Count(&Counters::deletes, index);
+	delete[] buffer;
+}
+
+Buffer::Allocator::Stats::Stats() {
+	uint32_t capacity(16);
+	for (uint8_t index = 0; index < 28; ++index) {
+		Class& stats(classes[index]);
+		stats.capacity = capacity;
+		stats.allocs = Sum(&Counters::allocs, index);
+		stats.frees = Sum(&Counters::frees, index);
+		stats.misses = Sum(&Counters::misses, index);
+		stats.hits = stats.allocs > stats.misses ? stats.allocs - stats.misses : 0;
+		uint64_t live = stats.allocs > stats.frees ? stats.allocs - stats.frees : 0;
+		uint64_t count = RaisePeak(index);
+		stats.liveBytes = live * capacity;
+		stats.pooledBytes = count > live ? (count - live) * capacity : 0;
+		stats.peakBytes = _Peaks[index].load(memory_order_relaxed) * capacity;
+		stats.reclaimedBytes = Sum(&Counters::reclaims, index) * capacity;
+
+		total.allocs += stats.allocs;
+		total.frees += stats.frees;
+		total.hits += stats.hits;
+		total.misses += stats.misses;
+		total.liveBytes += stats.liveBytes;
+		total.pooledBytes += stats.pooledBytes;
+		total.peakBytes += stats.peakBytes;
+		total.reclaimedBytes += stats.reclaimedBytes;
+		capacity <<= 1;
+	}
+}
+
+void Buffer::Allocator::Stats::log() const {
+	for (const Class& stats : classes) {
+		if (!stats.allocs)
+			continue;
+		INFO("Buffer ", stats.capacity, "B, live=", stats.liveBytes, "B, pooled=", stats.pooledBytes, "B, peak=", stats.peakBytes, "B, reclaimed=", stats.reclaimedBytes,
+			"B, allocs=", stats.allocs, ", frees=", stats.frees, ", hits=", stats.hits, ", misses=", stats.misses);
+	}
+	INFO("Buffer total, live=", total.liveBytes, "B, pooled=", total.pooledBytes, "B, peak=", total.peakBytes, "B, reclaimed=", total.reclaimedBytes,
+		"B, allocs=", total.allocs, ", frees=", total.frees, ", hits=", total.hits, ", misses=", total.misses);
+}
+
+char* Buffer::Allocator::Alloc(uint32_t& size) {
+	if (!size) {
+		Get(); // just access to Allocator to create it, to avoid a crash on static Buffer destruction with a Allocator access after deletion (see SerialisersTest for example)
+		return &_Empty;
+	}
+	size = ComputeCapacity(size);
+	if (size>0x80000000)
 		return new char[size];
+	Count(&Counters::allocs, ComputeIndex(size));
+	Allocator* pAllocator = LockFree().load(memory_order_acquire);
+	if (pAllocator)
+		return pAllocator->alloc(size);
+	if (!TryLock())
+		return New(size);
 	char* buffer = Get()->alloc(size);
 	Unlock();
 	return buffer;
 }
+uint32_t Buffer::Allocator::ComputeCapacity(uint32_t size) {
+	if (size <= 16)
+		return 16; // at minimum allocate 16 bytes!
+	// fast compute the closer upper power of two for new capacity
+	uint32_t capacity = size - 1;
+	capacity |= capacity >> 1;
+	capacity |= capacity >> 2;
+	capacity |= capacity >> 4;
+	capacity |= capacity >> 8;
+	capacity |= capacity >> 16;
+	return ++capacity ? capacity : size; // if = 0 exceeds uint32_t, keep original size required
+}
+
 void Buffer::Allocator::Free(char* buffer, uint32_t size) {
 	if (!size) {
 		if (buffer != &_Empty)
 			delete[] buffer;
 		return;
 	}
-	if ((size & (size - 1)) || !TryLock())  // check than we have a size create with Alloc (capacity log2) + TryLock working!
+	if (size & (size - 1)) // check than we have a size create with Alloc (capacity log2)
 		return delete[] buffer;
+	Count(&Counters::frees, ComputeIndex(size));
+	Allocator* pAllocator = LockFree().load(memory_order_acquire);
+	if (pAllocator)
+		return pAllocator->free(buffer, size);
+	if (!TryLock())
+		return Delete(buffer, size);
 	Get()->free(buffer, size);
 	Unlock();
 }
 
+uint8_t Buffer::Allocator::ComputeIndex(uint32_t capacity) {
+	--capacity;
+	// compute index
+	capacity = (capacity << 3) - capacity;    // Multiply by 7.
+	capacity = (capacity << 8) - capacity;    // Multiply by 255.
+	capacity = (capacity << 8) - capacity;    // Again.
+	capacity = (capacity << 8) - capacity;    // Again.
+	static uint8_t table[64] = { 100, 101, 99, 12, 99, 102, 25, 99, 13, 99, 99, 99, 103, 18, 26, 99,
+		99, 99, 16, 14, 7, 99, 9, 99, 99, 0, 99, 3, 99, 19, 27, 99,
+		11, 99, 24, 99, 99, 99, 17, 99, 15, 6, 8, 99, 2, 99, 99, 10,
+		23, 99, 99, 5, 99, 1, 99, 22, 99, 4, 21, 99, 20, 99, 28, 99 };
+	return table[capacity >> 26];
+}
+
 
 Buffer::Buffer(uint32_t size) : _offset(0), _size(size), _capacity(size) {
 	_data = _buffer = Allocator::Alloc(_capacity);
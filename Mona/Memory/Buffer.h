@@ -20,6 +20,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Memory/Bytes.h"
 #include <thread>
 #include <atomic>
+#include <vector>
 
 namespace Mona {
 
@@ -54,13 +55,80 @@ struct Buffer : Bytes, virtual Object {
 
 
 	struct Allocator : virtual Object {
+		/*!
+		Set the allocator, preferably before concurrent buffer usages.
+		A previous lock-free allocator is retired but never deleted, because it is called without lock
+		and a concurrent caller can be still inside it, it releases just its pooled buffers (see retire) */
 		template<typename AllocatorType=Allocator, typename ...Args>
-		static void   Set(Args&&... args) { Lock(); Get().set<AllocatorType>(std::forward<Args>(args)...); Unlock(); }
+		static void   Set(Args&&... args) {
+			Lock();
+			LockFree() = NULL;
+			Unique<Allocator> pPrevious(std::move(Get())); // deleted on return if not lock-free (called just under lock)
+			Get().set<AllocatorType>(std::forward<Args>(args)...);
+			if (Get()->lockFree())
+				LockFree() = Get().get();
+			Allocator* pRetired(NULL);
+			if (pPrevious && pPrevious->lockFree()) {
+				pRetired = pPrevious.get();
+				Retired().emplace_back(std::move(pPrevious));
+			}
+			Unlock();
+			// outside lock, an allocator can lock on garbage collection
+			if (pRetired)
+				pRetired->retire();
+		}
 		static char*  Alloc(uint32_t& size);
 		static void	  Free(char* buffer, uint32_t size);
+		/*!
+		Capacity allocated by Alloc for a size (power of two from 16 to 2^31, or size if bigger) */
+		static uint32_t ComputeCapacity(uint32_t size);
+		/*!
+		True if current allocator is lock-free (called without global lock, like BufferCache) */
+		static bool   IsLockFree() { return LockFree().load(std::memory_order_relaxed) ? true : false; }
+
+		/*!
+		Size class index of a capacity computed by Alloc (power of two from 16 to 2^31), 0 to 27 */
+		static uint8_t ComputeIndex(uint32_t capacity);
+		/*!
+		System allocation and release of a capacity computed by Alloc, to use by allocators to keep Stats exact,
+		reclaim=true when released by a pool garbage collector */
+		static char*  New(uint32_t capacity);
+		static void   Delete(char* buffer, uint32_t capacity, bool reclaim = false);
+
+		/*!
+		Snapshot of allocation statistics by size class, lock-free and cheap (approximative while buffers are used) */
+		struct Stats : virtual Object {
+			struct Class {
+				Class() : capacity(0), allocs(0), frees(0), hits(0), misses(0), liveBytes(0), pooledBytes(0), peakBytes(0), reclaimedBytes(0) {}
+				uint32_t capacity;
+				uint64_t allocs; // buffer allocations
+				uint64_t frees; // buffer releases
+				uint64_t hits; // allocations served by pool
+				uint64_t misses; // allocations served by system
+				uint64_t liveBytes; // bytes of living buffers
+				uint64_t pooledBytes; // bytes kept by pool
+				uint64_t peakBytes; // high-water mark of live+pooled bytes (sampled)
+				uint64_t reclaimedBytes; // bytes released to system by pool garbage collector
+			};
+			Stats();
+
+			Class classes[28];
+			Class total; // capacity=0
+			/*!
+			Log the used size classes with INFO level */
+			void log() const;
+		};
+
+		virtual ~Allocator() { if (LockFree() == this) LockFree() = NULL; }
 	protected:
-		virtual char*  alloc(uint32_t& capacity) { return new char[capacity]; }
-		virtual void   free(char* buffer, uint32_t capacity) { delete[] buffer; }
+		virtual char*  alloc(uint32_t& capacity) { return New(capacity); }
+		virtual void   free(char* buffer, uint32_t capacity) { Delete(buffer, capacity); }
+		/*!
+		Returns true if alloc and free are thread-safe, they are then called without the global lock */
+		virtual bool   lockFree() const { return false; }
+		/*!
+		Called on a lock-free allocator replaced by Set, it stays alive for concurrent callers but has to release its pooled buffers */
+		virtual void   retire() {}
 
 		static void Lock() { while (!TryLock()) std::this_thread::yield(); }
 		static void Unlock() { Mutex().clear(std::memory_order_release); }
@@ -69,6 +137,8 @@ struct Buffer : Bytes, virtual Object {
 
 		static Unique<Allocator>& Get() { static Unique<Allocator> PAllocator(SET); return PAllocator; }
 		static std::atomic_flag&  Mutex() { static std::atomic_flag Mutex = ATOMIC_FLAG_INIT; return Mutex; }
+		static std::atomic<Allocator*>& LockFree() { static std::atomic<Allocator*> PLockFree(NULL); return PLockFree; }
+		static std::vector<Unique<Allocator>>& Retired() { static std::vector<Unique<Allocator>> Retired; return Retired; }
 		
 	};
 private:
@@ -0,0 +1,262 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Memory/BufferCache.h"
+
+
+using namespace std;
+
+
+namespace Mona {
+
+#define BUFFER_CACHE_SLOTS		64 // batches by size class in depot
+#define BUFFER_CACHE_CLASSES	15 // size classes cached by thread, 16B to 256KB
+#define BUFFER_CACHE_BATCH		32u // max buffers by batch
+
+/*!
+Buffers are chained by batch in depot, next buffer pointer is written in buffer itself (capacity >= 16) */
+static char* Next(char* buffer) { char* next; memcpy(&next, buffer, sizeof(next)); return next; }
+static void  SetNext(char* buffer, char* next) { memcpy(buffer, &next, sizeof(next)); }
+static void  DeleteChain(char* chain, uint32_t capacity, bool reclaim = false) {
+	while (chain) {
+		char* next = Next(chain);
+		Buffer::Allocator::Delete(chain, capacity, reclaim);
+		chain = next;
+	}
+}
+
+struct BufferCache::Depot : virtual Object {
+	struct Class : virtual Object {
+		Class() : capacity(0), batch(0), _count(0), _minCount(0), _closed(false) {
+			for (atomic<char*>& slot : _slots)
+				slot = NULL;
+		}
+		~Class() {
+			for (atomic<char*>& slot : _slots)
+				DeleteChain(slot, capacity);
+		}
+		/*!
+		Push a chain of buffers, returns false if depot is full */
+		bool push(char* chain) {
+			if (_closed.load(memory_order_relaxed))
+				return false;
+			++_count; // before to publish, a concurrent pop can't decrement it below zero
+			for (atomic<char*>& slot : _slots) {
+				char* expected(NULL);
+				if (!slot.load(memory_order_relaxed) && slot.compare_exchange_strong(expected, chain)) {
+					if (_closed) // closed meanwhile, release it
+						drain();
+					return true;
+				}
+			}
+			--_count;
+			return false;
+		}
+		/*!
+		Pop a chain of buffers, exchange on slot makes it ABA-free */
+		char* pop() {
+			if (!_count.load(memory_order_relaxed))
+				return NULL;
+			for (atomic<char*>& slot : _slots) {
+				if (!slot.load(memory_order_relaxed))
+					continue;
+				char* chain = slot.exchange(NULL, memory_order_acquire);
+				if (!chain)
+					continue;
+				uint32_t count = --_count;
+				uint32_t minCount = _minCount;
+				while (count < minCount && !_minCount.compare_exchange_weak(minCount, count));
+				return chain;
+			}
+			return NULL;
+		}
+		/*!
+		Release chains unused since last call */
+		void manage() {
+			uint32_t unused = _minCount;
+			char* chain;
+			while (unused-- && (chain = pop()))
+				DeleteChain(chain, capacity, true);
+			_minCount = _count.load();
+		}
+		/*!
+		Release all chains and refuse next ones */
+		void close() {
+			_closed = true;
+			drain();
+		}
+
+		uint32_t capacity;
+		uint32_t batch;
+	private:
+		atomic<char*>		_slots[BUFFER_CACHE_SLOTS];
+		atomic<uint32_t>	_count;
+		atomic<uint32_t>	_minCount;
+		atomic<bool>		_closed;
+
+		void drain() {
+			char* chain;
+			while ((chain = pop()))
+				DeleteChain(chain, capacity, true);
+		}
+	};
+
+	Depot() {
+		uint32_t capacity(16);
+		for (Class& cls : classes) {
+			cls.capacity = capacity;
+			// batch of 64KB max
+			cls.batch = capacity < 0x10000 ? min<uint32_t>(0x10000 / capacity, BUFFER_CACHE_BATCH) : 1;
+			capacity <<= 1;
+		}
+	}
+	Class classes[28];
+};
+
+struct Cache {
+	/*!
+	Assign depot, the buffers of the previous one are given back to it */
+	void bind(const Shared<BufferCache::Depot>& pDepot) {
+		if (this->pDepot) {
+			for (uint8_t index = 0; index < BUFFER_CACHE_CLASSES; ++index) {
+				Magazine& magazine(magazines[index]);
+				BufferCache::Depot::Class& cls(this->pDepot->classes[index]);
+				while (magazine.count) {
+					char* chain(NULL);
+					for (uint32_t i = 0; i < cls.batch && magazine.count; ++i) {
+						char* buffer = magazine.buffers[--magazine.count];
+						SetNext(buffer, chain);
+						chain = buffer;
+					}
+					if (!cls.push(chain))
+						DeleteChain(chain, cls.capacity);
+				}
+			}
+		}
+		this->pDepot = pDepot;
+	}
+
+	struct Magazine {
+		Magazine() : count(0) {}
+		char*	 buffers[2 * BUFFER_CACHE_BATCH];
+		uint32_t count;
+	};
+	Shared<BufferCache::Depot> pDepot;
+	Magazine	magazines[BUFFER_CACHE_CLASSES];
+};
+
+#define CACHE_DEAD ((Cache*)1)
+static thread_local Cache* _PCache(NULL); // POD for a fast access, stays readable after thread cache destruction (CACHE_DEAD)
+
+static Cache* ThreadCache(const Shared<BufferCache::Depot>& pDepot) {
+	Cache* pCache = _PCache;
+	if (!pCache) {
+		static thread_local struct Holder {
+			~Holder() {
+				cache.bind(nullptr);
+				_PCache = CACHE_DEAD;
+			}
+			Cache cache;
+		} Holder;
+		_PCache = pCache = &Holder.cache;
+	} else if (pCache == CACHE_DEAD)
+		return NULL; // thread is ending
+	if (pCache->pDepot != pDepot)
+		pCache->bind(pDepot);
+	return pCache;
+}
+
+
+BufferCache::BufferCache(bool logStats) : _pDepot(SET), _logStats(logStats) {
+	start(Thread::PRIORITY_LOWEST);
+}
+
+char* BufferCache::alloc(uint32_t& capacity) {
+	uint8_t index = ComputeIndex(capacity);
+	Depot::Class& cls(_pDepot->classes[index]);
+	if (index >= BUFFER_CACHE_CLASSES) {
+		char* buffer = cls.pop(); // batch of one buffer
+		return buffer ? buffer : New(capacity);
+	}
+	Cache* pCache = ThreadCache(_pDepot);
+	if (!pCache)
+		return New(capacity); // thread is ending
+	Cache::Magazine& magazine(pCache->magazines[index]);
+	if (magazine.count)
+		return magazine.buffers[--magazine.count];
+	// refill magazine with a batch
+	char* buffer = cls.pop();
+	if (!buffer)
+		return New(capacity);
+	char* next;
+	while ((next = Next(buffer))) {
+		magazine.buffers[magazine.count++] = buffer;
+		buffer = next;
+	}
+	return buffer;
+}
+
+void BufferCache::free(char* buffer, uint32_t capacity) {
+	uint8_t index = ComputeIndex(capacity);
+	Depot::Class& cls(_pDepot->classes[index]);
+	if (index >= BUFFER_CACHE_CLASSES) {
+		SetNext(buffer, NULL);
+		if (!cls.push(buffer))
+			Delete(buffer, capacity);
+		return;
+	}
+	Cache* pCache = ThreadCache(_pDepot);
+	if (!pCache)
+		return Delete(buffer, capacity); // thread is ending
+	Cache::Magazine& magazine(pCache->magazines[index]);
+	if (magazine.count == 2 * cls.batch) {
+		// magazine full, transfer the oldest batch to depot
+		char* chain(NULL);
+		for (uint32_t i = 0; i < cls.batch; ++i) {
+			SetNext(magazine.buffers[i], chain);
+			chain = magazine.buffers[i];
+		}
+		magazine.count -= cls.batch;
+		memmove(magazine.buffers, magazine.buffers + cls.batch, magazine.count * sizeof(char*));
+		if (!cls.push(chain))
+			DeleteChain(chain, capacity);
+	}
+	magazine.buffers[magazine.count++] = buffer;
+}
+
+void BufferCache::retire() {
+	stop();
+	for (Depot::Class& cls : _pDepot->classes)
+		cls.close(); // thread caches will delete their buffers rather than give them back
+}
+
+bool BufferCache::run(Exception& ex, const volatile bool& requestStop) {
+	uint16_t timeout = 10000;
+	while (!requestStop) {
+		if (timeout && wakeUp.wait(timeout)) // wait()==true means requestStop=true because there is no other wakeUp.set elsewhere
+			return true;
+		Time time;
+		for (Depot::Class& cls : _pDepot->classes)
+			cls.manage(); // garbage collector!
+		if (_logStats)
+			Stats().log();
+		timeout = (uint16_t)max(10000 - time.elapsed(), 0);
+	}
+	return true;
+}
+
+
+} // namespace Mona
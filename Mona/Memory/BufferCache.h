@@ -0,0 +1,51 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Memory/Buffer.h"
+#include "Mona/Threading/Thread.h"
+
+namespace Mona {
+
+/*!
+Lock-free buffer allocator, to select with Buffer::Allocator::Set<BufferCache>().
+Each thread keeps a magazine of buffers by size class exchanged by batch with lock-free depots shared between threads
+(like tcmalloc transfer caches), big buffers (>256KB) go directly to depots.
+As BufferPool a garbage collector releases every 10 seconds the depot buffers unused during this period */
+struct BufferCache : Buffer::Allocator, private Thread, virtual Object {
+
+	/*!
+	logStats=true to log Buffer::Allocator::Stats after each garbage collection (every 10 seconds) */
+	BufferCache(bool logStats = false);
+	~BufferCache() { stop(); }
+
+	struct Depot;
+private:
+	char* alloc(uint32_t& capacity) override;
+	void  free(char* buffer, uint32_t capacity) override;
+	bool  lockFree() const override { return true; }
+	void  retire() override;
+
+	bool run(Exception& ex, const volatile bool& requestStop);
+
+	const Shared<Depot>	_pDepot; // shared with thread caches which can outlive the allocator
+	const bool			_logStats;
+};
+
+
+} // namespace Mona
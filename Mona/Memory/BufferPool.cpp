@@ -22,6 +22,15 @@ using namespace std;
 
 namespace Mona {
 
+BufferPool::~BufferPool() {
+	stop();
+	uint32_t capacity(16);
+	for (Buffers& buffers : _buffers) {
+		buffers.release(capacity);
+		capacity <<= 1;
+	}
+}
+
 char* BufferPool::Buffers::pop() {
 	if (empty())
 		return NULL;
@@ -49,39 +58,35 @@ void BufferPool::Buffers::manage(vector<char*>& gc) {
 	_maxSize = 0;
 }
 
+void BufferPool::Buffers::release(uint32_t capacity) {
+	for (char* buffer : self)
+		Delete(buffer, capacity);
+	clear();
+	_minSize = _maxSize = 0;
+}
+
 bool BufferPool::run(Exception& ex, const volatile bool& requestStop) {
 	uint16_t timeout = 10000;
 	while (!requestStop) {
 		if (timeout && wakeUp.wait(timeout)) // wait()==true means requestStop=true because there is no other wakeUp.set elsewhere
 			return true;
 		Time time;
+		uint32_t capacity(16);
 		for (Buffers& buffers : _buffers) {
 			vector<char*> gc;
 			Lock();
 			buffers.manage(gc); // garbage collector!
 			Unlock();
 			for (char* buffer : gc)
-				delete[] buffer;
+				Delete(buffer, capacity, true);
+			capacity <<= 1;
 		}
+		if (_logStats)
+			Stats().log();
 		timeout = (uint16_t)max(10000 - time.elapsed(), 0);
 	}
 	return true;
 }
 
-uint8_t BufferPool::computeIndex(uint32_t capacity) {
-	--capacity;
-	// compute index
-	capacity = (capacity << 3) - capacity;    // Multiply by 7.
-	capacity = (capacity << 8) - capacity;    // Multiply by 255.
-	capacity = (capacity << 8) - capacity;    // Again.
-	capacity = (capacity << 8) - capacity;    // Again.
-	static uint8_t table[64] = { 100, 101, 99, 12, 99, 102, 25, 99, 13, 99, 99, 99, 103, 18, 26, 99,
-		99, 99, 16, 14, 7, 99, 9, 99, 99, 0, 99, 3, 99, 19, 27, 99,
-		11, 99, 24, 99, 99, 99, 17, 99, 15, 6, 8, 99, 2, 99, 99, 10,
-		23, 99, 99, 5, 99, 1, 99, 22, 99, 4, 21, 99, 20, 99, 28, 99 };
-	return table[capacity >> 26];
-}
-
-
 
 } // namespace Mona
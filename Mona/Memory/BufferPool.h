@@ -24,30 +24,32 @@ namespace Mona {
 
 struct BufferPool : Buffer::Allocator, private Thread, virtual Object {
 
-	BufferPool() { start(Thread::PRIORITY_LOWEST); }
-	~BufferPool() { stop(); }
+	/*!
+	logStats=true to log Buffer::Allocator::Stats after each garbage collection (every 10 seconds) */
+	BufferPool(bool logStats = false) : _logStats(logStats) { start(Thread::PRIORITY_LOWEST); }
+	~BufferPool();
 
 private:
 	char* alloc(uint32_t& capacity) override {
-		char* buffer = _buffers[computeIndex(capacity)].pop();
-		return buffer ? buffer : new char[capacity];
+		char* buffer = _buffers[ComputeIndex(capacity)].pop();
+		return buffer ? buffer : New(capacity);
 	}
-	void free(char* buffer, uint32_t capacity) override { _buffers[computeIndex(capacity)].push(buffer); }
+	void free(char* buffer, uint32_t capacity) override { _buffers[ComputeIndex(capacity)].push(buffer); }
 
 	bool run(Exception& ex, const volatile bool& requestStop);
-	uint8_t computeIndex(uint32_t capacity);
 
 	struct Buffers : private std::vector<char*>, virtual Object {
 		Buffers() : _minSize(0), _maxSize(0) {}
-		~Buffers() { for (char* buffer : self) delete[] buffer; }
 		char*	pop();
 		void   push(char* buffer);
 		void	manage(std::vector<char*>& gc);
+		void	release(uint32_t capacity);
 	private:
 		uint32_t _minSize;
 		uint32_t _maxSize;
 	};
 	Buffers			 _buffers[28];
+	const bool		 _logStats;
 };
 
 
@@ -0,0 +1,146 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Memory/Rope.h"
+
+using namespace std;
+
+
+namespace Mona {
+
+Rope& Rope::append(const Packet& packet) {
+	if (!packet)
+		return self;
+	if (packet.buffer())
+		_packets.emplace_back(move(packet)); // share buffer (no copy)
+	else
+		_packets.emplace_back(packet); // reference unbuffered data, see bufferize()
+	_size += packet.size();
+	return self;
+}
+
+Rope& Rope::bufferize() {
+	for (Packet& packet : _packets) {
+		if (!packet.buffer())
+			packet = Packet(move(packet)); // copy!
+		else if (packet.size() < (packet.buffer()->size() >> 2))
+			packet = Packet(Shared<Buffer>(SET, packet.data(), packet.size())); // copy a small part to not hold the whole big buffer
+	}
+	return self;
+}
+
+Rope& Rope::clear() {
+	_pBuffer.reset();
+	_packets.clear();
+	_size = 0;
+	return self;
+}
+
+Rope& Rope::clip(uint32_t count) {
+	if (count >= _size)
+		return clear();
+	_size -= count;
+	if (_pBuffer) {
+		if (count < _pBuffer->size()) {
+			if (_pBuffer.unique()) {
+				_pBuffer->clip(count);
+				return self;
+			}
+			// hold by user, buffer immutable now => becomes a simple chunk
+			_packets.emplace_front(static_pointer_cast<const Bytes>(_pBuffer), _pBuffer->data() + count, _pBuffer->size() - count);
+			_pBuffer.reset();
+			return self;
+		}
+		count -= _pBuffer->size();
+		_pBuffer.reset();
+	}
+	while (count) {
+		Packet& packet = _packets.front();
+		if (count < packet.size()) {
+			packet += count;
+			break;
+		}
+		count -= packet.size();
+		_packets.pop_front();
+	}
+	return self;
+}
+
+Packet Rope::front(uint32_t size) {
+	if (size > _size)
+		size = _size;
+	if (!size)
+		return nullptr;
+	uint32_t buffered = _pBuffer ? _pBuffer->size() : 0;
+	if (!buffered && size <= _packets.front().size())
+		return Packet(_packets.front(), _packets.front().data(), size); // in one chunk, no copy
+	if (size > buffered) {
+		// materialize!
+		if (!_pBuffer)
+			_pBuffer.set();
+		else if (!_pBuffer.unique()) // hold by user, buffer immutable now
+			_pBuffer.set(_pBuffer->data(), buffered);
+		uint32_t missing = size - buffered;
+		while (missing) {
+			Packet& packet = _packets.front();
+			if (missing < packet.size()) {
+				_pBuffer->append(packet.data(), missing);
+				packet += missing;
+				break;
+			}
+			_pBuffer->append(packet.data(), packet.size());
+			missing -= packet.size();
+			_packets.pop_front();
+		}
+	}
+	return Packet(static_pointer_cast<const Bytes>(_pBuffer), _pBuffer->data(), size); // trick to keep reference to _pBuffer!
+}
+
+uint8_t Rope::operator[](uint32_t index) const {
+	DEBUG_ASSERT(index < _size);
+	uint8_t value(0);
+	forEach([&](const char* data, uint32_t size) {
+		if (index >= size) {
+			index -= size;
+			return true;
+		}
+		value = data[index];
+		return false;
+	});
+	return value;
+}
+
+uint32_t Rope::copy(uint32_t offset, void* data, uint32_t size) const {
+	uint32_t copied(0);
+	forEach([&](const char* chunk, uint32_t available) {
+		if (offset >= available) {
+			offset -= available;
+			return true;
+		}
+		available -= offset;
+		if (available > size)
+			available = size;
+		memcpy((char*)data + copied, chunk + offset, available);
+		copied += available;
+		size -= available;
+		offset = 0;
+		return size ? true : false;
+	});
+	return copied;
+}
+
+
+} // namespace Mona
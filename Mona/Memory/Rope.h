@@ -0,0 +1,87 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Memory/Packet.h"
+#include <deque>
+
+namespace Mona {
+
+/*!
+Rope is a chain of Packet which accumulates received data without copying it (every chunk is a reference),
+and which presents the chain contiguously just on demand: front(size) materializes only the bytes requested
+when they straddle several chunks (in a buffer which grows with next requests as a classic reassembly buffer).
+Beware, appended unbuffered packets are just referenced, call bufferize() to hold the rope beyond their life */
+struct Rope : virtual Object {
+	NULLABLE(!_size)
+
+	Rope() : _size(0) {}
+	Rope(Rope&& rope) : _size(rope._size), _pBuffer(std::move(rope._pBuffer)), _packets(std::move(rope._packets)) { rope._size = 0; }
+
+	/*!
+	Total size of data */
+	uint32_t	size() const { return _size; }
+	/*!
+	Number of chunks */
+	uint32_t	count() const { return _packets.size() + (_pBuffer ? 1 : 0); }
+
+	/*!
+	Add packet at the end of the chain (no copy, buffer shared or unbuffered data referenced) */
+	Rope&		append(const Packet& packet);
+	/*!
+	Copy data of unbuffered packets referenced to allow to hold the rope beyond the life of appended packets,
+	and copy packets much smaller than their shared buffer to not hold it */
+	Rope&		bufferize();
+	/*!
+	Remove count bytes from the beginning */
+	Rope&		clip(uint32_t count);
+	Rope&		clear();
+
+	/*!
+	Get the first size bytes as a contiguous Packet, without copy if they are in one chunk, otherwise they are
+	materialized one time (the chain is updated to keep this contiguous part) */
+	Packet		front(uint32_t size = 0xFFFFFFFF);
+
+	/*!
+	Read a byte, index has to be inferior to size() */
+	uint8_t		operator[](uint32_t index) const;
+	/*!
+	Copy size bytes from offset to data without materialization, returns count of bytes copied */
+	uint32_t	copy(uint32_t offset, void* data, uint32_t size) const;
+
+	/*!
+	Call function(const char* data, uint32_t size) for each chunk, stops if function returns false (and returns false) */
+	template<typename FunctionType>
+	bool		forEach(const FunctionType& function) const {
+		if (_pBuffer && !function(_pBuffer->data(), _pBuffer->size()))
+			return false;
+		for (const Packet& packet : _packets) {
+			if (!function(packet.data(), packet.size()))
+				return false;
+		}
+		return true;
+	}
+
+private:
+	uint32_t			_size;
+	Shared<Buffer>		_pBuffer; // contiguous part materialized, always in front
+	std::deque<Packet>	_packets;
+};
+
+
+} // namespace Mona
@@ -29,6 +29,15 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #if !defined(EPOLLRDHUP)  // ANDROID
 #define EPOLLRDHUP 0x2000 // looks be just a SDL include forget for Android, but the event is implemented in epoll of Android
 #endif  // !defined(EPOLLRDHUP) 
+	#include "Mona/Net/IOUring.h"
+	#include <unordered_map>
+#if defined(URING_API)
+	#include <sys/eventfd.h>
+#endif
+#if defined(__linux__)
+	#include <netinet/udp.h>
+	#include <sys/mman.h>
+#endif
 #endif
 #include "Mona/Net/SRT.h"
 #if defined(SRT_API)
@@ -40,6 +49,33 @@ using namespace std;
 
 namespace Mona {
 
+#if defined(URING_API)
+// io_uring user_data = Weak<Socket>* | request type (pointer aligned at least on 8 bytes)
+enum {
+	URING_POLL = 0,
+	URING_STREAM, // multishot recv
+	URING_DATAGRAM, // multishot recvmsg
+	URING_ACCEPT, // multishot accept
+	URING_PIPE, // with a null pointer
+	URING_RESUMPTION, // with a null pointer
+	URING_MASK = 7
+};
+// pipe messages = Weak<Socket>* | message type
+enum {
+	URING_REMOVE = 0, // same pointer than epoll/kqueue unsubscription
+	URING_ADD,
+	URING_RESUME // reception paused on backpressure can be rearmed
+};
+enum {
+	URING_GROUP_DATAGRAM = 0,
+	URING_GROUP_STREAM
+};
+enum {
+	URING_DATAGRAM_SIZE = 0x10000 + sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in6), // max UDP size + recvmsg header and address
+	URING_COPYBREAK = 2048 // smaller reception is copied rather than to keep busy a provided buffer (64KB for a datagram)
+};
+#endif
+
 struct IOSocket::Action : Runner, virtual Object {
 	Action(const char* name, int error, const Shared<Socket>& pSocket) : Runner(name), _weakSocket(pSocket) {
 		if (error)
@@ -93,8 +129,12 @@ private:
 };
 
 
-IOSocket::IOSocket(const Handler& handler, const ThreadPool& threadPool) : _initSignal(false),
-   _system(0), _subscribers(0),handler(handler), threadPool(threadPool) {
+IOSocket::IOSocket(const Handler& handler, const ThreadPool& threadPool, uint16_t reactors, Balancing balancing, Engine engine) : _initSignal(false),
+   _system(0), _subscribers(0), _balancing(balancing), _engine(engine), _pAggregate(SET), handler(handler), threadPool(threadPool) {
+	if (reactors > 1)
+		_reactors.resize(reactors - 1);
+	for (Unique<IOSocket>& pReactor : _reactors)
+		pReactor.set(handler, threadPool, 1, BALANCING_LOAD, engine);
 }
 
 IOSocket::~IOSocket() {
@@ -131,6 +171,12 @@ bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket,
 	pSocket->_onReceived = onReceived;
 	pSocket->_onFlush = onFlush;
 	pSocket->_pHandler = &handler;
+	if (!pSocket->_pAggregate) {
+		// aggregated metrics, includes data queued before subscription
+		pSocket->_pAggregate = _pAggregate;
+		_pAggregate->queueing += pSocket->_queueing;
+		pSocket->_aggregate = _pAggregate.get();
+	}
 
 	if (pSocket->type < Socket::TYPE_OTHER) {
 		if (subscribe(ex, pSocket))
@@ -155,7 +201,50 @@ bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket,
 	return false;
 }
 
+uint32_t IOSocket::subscribers() const {
+	uint32_t count(_subscribers);
+	for (const Unique<IOSocket>& pReactor : _reactors)
+		count += pReactor->_subscribers;
+	return count;
+}
+
+void IOSocket::collect(Metrics::Writer& writer, const string& prefix) const {
+	writer.write(prefix + "_sockets", Metrics::TYPE_GAUGE, subscribers(), "Sockets subscribed");
+	writer.write(prefix + "_received_bytes_total", _pAggregate->recvBytes, "Bytes received");
+	writer.write(prefix + "_receptions_total", _pAggregate->recvCount, "Receptions");
+	writer.write(prefix + "_sent_bytes_total", _pAggregate->sendBytes, "Bytes sent");
+	writer.write(prefix + "_sendings_total", _pAggregate->sendCount, "Sendings");
+	writer.write(prefix + "_queueing_bytes", _pAggregate->queueing, "Bytes waiting to be sent (backpressure)");
+}
+
+uint16_t IOSocket::reactor(const Socket& socket) const {
+	if (_balancing == BALANCING_HASH)
+		return uint16_t(std::hash<NET_SOCKET>()(socket.id()) % (_reactors.size() + 1));
+	// BALANCING_LOAD
+	uint16_t reactor(0);
+	uint32_t subscribers(_subscribers);
+	for (uint16_t i = 0; i < _reactors.size(); ++i) {
+		uint32_t count(_reactors[i]->_subscribers);
+		if (count >= subscribers)
+			continue;
+		subscribers = count;
+		reactor = i + 1;
+	}
+	return reactor;
+}
+
 bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket) {
+	if (!_reactors.empty()) {
+		uint16_t reactor(this->reactor(*pSocket));
+		if (reactor) {
+			pSocket->_reactor = reactor; // before subscription, the child reactor can unsubscribe it immediately on an event
+			if (_reactors[reactor - 1]->subscribe(ex, pSocket))
+				return true;
+			pSocket->_reactor = 0;
+			return false;
+		}
+	}
+
 	lock_guard<mutex> lock(_mutex); // must protect "start" + _system (to avoid a write operation on restarting) + _subscribers increment
 	if (!running()) {
 		_initSignal.reset();
@@ -185,12 +274,21 @@ bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket) {
 	EV_SET(&events[1], *pSocket, EVFILT_WRITE, EV_ADD | EV_CLEAR, 0, 0, pSocket->_pWeakThis);
 	res = kevent(_system, events, 2, NULL, 0, NULL);
 #else
-	epoll_event event;
-	memset(&event, 0, sizeof(event));
-	event.events = EPOLLIN | EPOLLRDHUP | EPOLLOUT | EPOLLET;
-	event.data.fd = *pSocket;
-	event.data.ptr = pSocket->_pWeakThis;
-	res = epoll_ctl(_system, EPOLL_CTL_ADD, *pSocket, &event);
+#if defined(URING_API)
+	if (_engine == ENGINE_URING) {
+		// io_uring requests are submitted by the IOSocket thread itself
+		uintptr_t message(uintptr_t(pSocket->_pWeakThis) | URING_ADD);
+		res = ::write(_eventFD, &message, sizeof(message)) == sizeof(message) ? 0 : -1;
+	} else
+#endif
+	{
+		epoll_event event;
+		memset(&event, 0, sizeof(event));
+		event.events = EPOLLIN | EPOLLRDHUP | EPOLLOUT | EPOLLET;
+		event.data.fd = *pSocket;
+		event.data.ptr = pSocket->_pWeakThis;
+		res = epoll_ctl(_system, EPOLL_CTL_ADD, *pSocket, &event);
+	}
 #endif
 	if (res<0) {
 		delete pSocket->_pWeakThis;
@@ -198,6 +296,13 @@ bool IOSocket::subscribe(Exception& ex, const Shared<Socket>& pSocket) {
 		ex.set<Ex::Net::System>(Net::LastErrorMessage(), ", ", name(), " can't manage sockets");
 		return false;
 	}
+#if defined(UDP_GRO)
+	// datagrams coalesced by kernel are splitted by Receive::process (batch), not supported by io_uring engine
+	if (pSocket->type == Socket::TYPE_DATAGRAM && _engine != ENGINE_URING && !pSocket->isSecure()) {
+		int enable(1);
+		setsockopt(*pSocket, SOL_UDP, UDP_GRO, &enable, sizeof(enable)); // ignore error, optional
+	}
+#endif
 #endif
 	++_subscribers;
 	
@@ -222,6 +327,9 @@ void IOSocket::unsubscribe(Shared<Socket>& pSocket) {
 }
 
 void IOSocket::unsubscribe(Socket* pSocket) {
+	uint16_t reactor(pSocket->_reactor.exchange(0));
+	if (reactor)
+		return _reactors[reactor - 1]->unsubscribe(pSocket);
 #if defined(_WIN32)
 	{
 		// decrements _count before the PostMessage
@@ -252,9 +360,14 @@ void IOSocket::unsubscribe(Socket* pSocket) {
 		EV_SET(&events[1], *pSocket, EVFILT_WRITE, EV_DELETE, 0, 0, NULL);
 		kevent(_system, events, 2, NULL, 0, NULL);
 #else
-		epoll_event event;
-		memset(&event, 0, sizeof(event));
-		epoll_ctl(_system, EPOLL_CTL_DEL, *pSocket, &event);
+#if defined(URING_API)
+		if (_engine != ENGINE_URING) // io_uring requests are cancelled by the IOSocket thread on pointer reception
+#endif
+		{
+			epoll_event event;
+			memset(&event, 0, sizeof(event));
+			epoll_ctl(_system, EPOLL_CTL_DEL, *pSocket, &event);
+		}
 #endif
 		if (::write(_eventFD, &pSocket->_pWeakThis, sizeof(pSocket->_pWeakThis)) >= 0)
 			pSocket->_pWeakThis = NULL; // success!
@@ -352,9 +465,168 @@ void IOSocket::read(const Shared<Socket>& pSocket, int error) {
 			ThreadQueue*		_pThread;
 		};
 
+#if defined(__linux__)
+		struct Datagram {
+			Datagram(Shared<Buffer>& pBuffer, const SocketAddress& address) : pBuffer(move(pBuffer)), address(address) {}
+			Shared<Buffer>	pBuffer;
+			SocketAddress	address;
+		};
+		struct Datagrams : Action::Handle {
+			Datagrams(const char* name, const Shared<Socket>& pSocket, const Exception& ex, vector<Datagram>& datagrams, uint32_t size, bool& stop) :
+				Action::Handle(name, pSocket, ex), _datagrams(move(datagrams)), _size(size), _pThread(NULL) {
+				if ((pSocket->_receiving += _size) < pSocket->recvBufferSize())
+					return;
+				stop = true;
+				_pThread = ThreadQueue::Current();
+				++pSocket->_reading;
+			}
+		private:
+			void handle(const Shared<Socket>& pSocket) {
+				// one handler wakeup for all the datagrams of the batch
+				for (Datagram& datagram : _datagrams)
+					pSocket->_onReceived(datagram.pBuffer, datagram.address);
+				uint32_t receiving = pSocket->_receiving -= _size;
+				if (!_pThread)
+					return;
+				if (receiving < pSocket->recvBufferSize())
+					_pThread->queue<Receive>(0, pSocket); // REARM
+				else
+					--pSocket->_reading;
+			}
+			vector<Datagram>	_datagrams;
+			uint32_t			_size;
+			ThreadQueue*		_pThread;
+		};
+
+		/*!
+		Receive datagrams by batch with recvmmsg directly in pooled buffers kept by receiving thread (no copy up to MTU),
+		bigger datagrams and GRO coalescing overflow in a slab mapped by thread from where they are copied */
+		bool processDatagrams(Exception& ex, const Shared<Socket>& pSocket) {
+			enum {
+				BATCH = 32,
+				MTU = 2048, // greater than max possible MTU (~1500 bytes)
+				SLOT = 0x10000, // max UDP size (and max GRO coalescing)
+				EXTRA = SLOT - MTU
+			};
+			thread_local struct Slab {
+				// anonymous mapping without swap reservation, just the pages touched by big datagrams are really allocated
+				Slab() : overflow((char*)mmap(NULL, BATCH * EXTRA, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0)) {
+					if (overflow == MAP_FAILED)
+						overflow = NULL;
+				}
+				~Slab() {
+					if (overflow)
+						munmap(overflow, BATCH * EXTRA);
+				}
+				mmsghdr			headers[BATCH];
+				iovec			iovecs[BATCH][2];
+				sockaddr_in6	addresses[BATCH];
+				char			controls[BATCH][CMSG_SPACE(sizeof(int))];
+				Shared<Buffer>	pBuffers[BATCH]; // delivered as is, so renewed only when consumed
+				char*			overflow;
+				vector<Shared<Buffer>> segments;
+			} Slab;
+			bool stop(false);
+			while (!stop) {
+				for (uint32_t i = 0; i < BATCH; ++i) {
+					mmsghdr& header(Slab.headers[i]);
+					memset(&header, 0, sizeof(header));
+					Shared<Buffer>& pBuffer(Slab.pBuffers[i]);
+					BUFFER_RESET(pBuffer, MTU);
+					Slab.iovecs[i][0].iov_base = pBuffer->data();
+					Slab.iovecs[i][0].iov_len = MTU;
+					Slab.iovecs[i][1].iov_base = Slab.overflow + i * EXTRA;
+					Slab.iovecs[i][1].iov_len = EXTRA;
+					header.msg_hdr.msg_iov = Slab.iovecs[i];
+					header.msg_hdr.msg_iovlen = Slab.overflow ? 2 : 1; // without mapping datagrams bigger than MTU are truncated
+					header.msg_hdr.msg_name = &Slab.addresses[i];
+					header.msg_hdr.msg_namelen = sizeof(Slab.addresses[i]);
+					header.msg_hdr.msg_control = Slab.controls[i];
+					header.msg_hdr.msg_controllen = sizeof(Slab.controls[i]);
+				}
+				int count;
+				do {
+					count = recvmmsg(*pSocket, Slab.headers, BATCH, 0, NULL);
+				} while (count < 0 && Net::LastError() == NET_EINTR);
+				if (count < 0) {
+					int error(Net::LastError());
+					if (error == NET_EWOULDBLOCK)
+						return true;
+					Socket::SetException(error, ex, " (batch=", BATCH, ")");
+					return false;
+				}
+
+				vector<Datagram> datagrams;
+				datagrams.reserve(count);
+				uint32_t size(0);
+				for (int i = 0; i < count; ++i) {
+					const msghdr& header(Slab.headers[i].msg_hdr);
+					if (header.msg_flags & MSG_TRUNC) {
+						// can't happen excepting with GRO unsupported, UDP packet lost
+						WARN("Datagram truncated, ", Slab.headers[i].msg_len, " bytes received from ", SocketAddress((sockaddr&)Slab.addresses[i]));
+						continue;
+					}
+					uint32_t received(Slab.headers[i].msg_len);
+					uint32_t segment(received);
+					for (cmsghdr* pControl = CMSG_FIRSTHDR(&header); pControl; pControl = CMSG_NXTHDR((msghdr*)&header, pControl)) {
+#if defined(UDP_GRO)
+						if (pControl->cmsg_level == SOL_UDP && pControl->cmsg_type == UDP_GRO)
+							memcpy(&segment, CMSG_DATA(pControl), sizeof(int));
+#endif
+					}
+					Shared<Buffer>& pBuffer(Slab.pBuffers[i]);
+					const char* overflow(Slab.overflow + i * EXTRA);
+					if (segment && segment < received) {
+						// GRO, copy the following segments before to deliver the first one in place
+						for (uint32_t position = segment; position < received; position += segment) {
+							Slab.segments.emplace_back(SET, min(segment, received - position));
+							Buffer& buffer(*Slab.segments.back());
+							uint32_t head(position < MTU ? min<uint32_t>(MTU - position, buffer.size()) : 0);
+							if (head)
+								memcpy(buffer.data(), pBuffer->data() + position, head);
+							if (head < buffer.size())
+								memcpy(buffer.data() + head, overflow + (position + head - MTU), buffer.size() - head);
+						}
+						received = segment;
+					}
+					// a zero-length datagram is delivered too (valid for UDP)
+					if (received > MTU) {
+						pBuffer->resize(received); // rare, bigger than MTU
+						memcpy(pBuffer->data() + MTU, overflow, received - MTU);
+					} else
+						pBuffer->resize(received);
+					SocketAddress address((sockaddr&)Slab.addresses[i]);
+					for (uint32_t j = 0; j <= Slab.segments.size(); ++j) {
+						Shared<Buffer>& pDatagram(j ? Slab.segments[j - 1] : pBuffer);
+						// decode can't happen BEFORE onDisconnection because this call decode + push to _handler in this call!
+						if (pSocket->_pDecoder)
+							pSocket->_pDecoder->decode(pDatagram, address, pSocket);
+						if (pDatagram) {
+							size += pDatagram->size();
+							datagrams.emplace_back(pDatagram, address);
+						}
+					}
+					Slab.segments.clear();
+					pSocket->receive(Slab.headers[i].msg_len);
+				}
+				if (!pSocket->_address)
+					pSocket->_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+				if (!datagrams.empty())
+					handle<Datagrams>(pSocket, datagrams, size, stop);
+				if (count < BATCH)
+					return true; // socket empty, next datagram will raise a new read event
+			}
+			return true;
+		}
+#endif
+
 		bool process(Exception& ex, const Shared<Socket>& pSocket) {
 			if (!pSocket->_reading--) // me and something else! useless!
 				return true;
+#if defined(__linux__)
+			if (pSocket->type == Socket::TYPE_DATAGRAM && !pSocket->isSecure())
+				return processDatagrams(ex, pSocket);
+#endif
 			bool stop(false);
 			while (!stop) {
 				uint32_t available = pSocket->available();
@@ -425,7 +697,7 @@ void IOSocket::write(const Shared<Socket>& pSocket, int error) {
 			}
 		};
 	};
-	threadPool.queue<Send>(0, error, pSocket);
+	threadPool.queue<Send>(pSocket->_threadSend, error, pSocket);
 }
 
 
@@ -483,6 +755,20 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 	// and not too high because could exceed stack limitation of 1Mo like on Android
 #define MAXEVENTS  1024
 
+#if defined(URING_API)
+	if (_engine == ENGINE_URING && readFD>0 && _eventFD>0) {
+		IOUring uring;
+		Exception exURing;
+		if (uring.init(exURing, MAXEVENTS) &&
+			uring.addBuffers(exURing, URING_GROUP_DATAGRAM, 64, URING_DATAGRAM_SIZE) &&
+			uring.addBuffers(exURing, URING_GROUP_STREAM, 128, 0x4000) &&
+			fcntl(readFD, F_SETFL, fcntl(readFD, F_GETFL, 0) | O_NONBLOCK) != -1)
+			return runURing(ex, uring, readFD);
+		WARN(name(), " fallbacks to epoll engine, ", exURing);
+		_engine = ENGINE_DEFAULT;
+	}
+#endif
+
 #if defined(_BSD)
 	struct kevent events[MAXEVENTS];
 	if(readFD>0 && _eventFD>0 && fcntl(readFD, F_SETFL, fcntl(readFD, F_GETFL, 0) | O_NONBLOCK)!=-1)
@@ -529,6 +815,7 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 	MSG msg;
 	
 	while ((result=GetMessage(&msg, _system, 0, 0)) > 0) {
+		Time::Tick(); // refresh Time::Coarse() for this event
 		
 		if (!_subscribers) {
 			lock_guard<mutex> lock(_mutex);
@@ -590,6 +877,7 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 #else
 		result = epoll_wait(_system,events, MAXEVENTS, -1);
 #endif
+		Time::Tick(); // refresh Time::Coarse() for these events
 
 		int i;
 		if (result < 0) {
@@ -721,12 +1009,556 @@ bool IOSocket::run(Exception& ex, const volatile bool& requestStop) {
 	ex.set<Ex::Net::System>("dies with remaining sockets managed");
 	return false;
 }
+
+#if defined(URING_API)
+
+bool IOSocket::runURing(Exception& ex, IOUring& uring, int readFD) {
+	/*!
+	Receptions paused on backpressure to rearm, pushed by handling threads and processed by this reactor thread,
+	eventfd is closed under lock on reactor end to never write on a reused descriptor */
+	struct Resumption : virtual Object {
+		Resumption() : fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+		~Resumption() { close(); }
+		void close() {
+			lock_guard<mutex> lock(_mutex);
+			if (fd >= 0)
+				::close(fd);
+			fd = -1;
+		}
+		void push(Weak<Socket>* pWeakSocket) {
+			lock_guard<mutex> lock(_mutex);
+			if (fd < 0)
+				return; // reactor end
+			_sockets.emplace_back(pWeakSocket);
+			uint64_t count(1);
+			if (::write(fd, &count, sizeof(count)) < 0)
+				return; // counter overflow impossible
+		}
+		vector<Weak<Socket>*>& pop(vector<Weak<Socket>*>& sockets) {
+			uint64_t count;
+			lock_guard<mutex> lock(_mutex);
+			if (::read(fd, &count, sizeof(count)) >= 0)
+				sockets.swap(_sockets);
+			return sockets;
+		}
+		int fd;
+	private:
+		mutex					_mutex;
+		vector<Weak<Socket>*>	_sockets;
+	};
+	Shared<Resumption> pResumption(SET);
+	if (pResumption->fd < 0) {
+		::close(_eventFD);
+		::close(readFD);
+		_system = 0;
+		_initSignal.set();
+		ex.set<Ex::Net::System>("impossible to start IOSocket, io_uring resumption event, ", strerror(errno));
+		return false;
+	}
+	_system = uring.fd();
+	_initSignal.set();
+
+	struct Reception : Action {
+		Reception(const char* name, const Shared<Socket>& pSocket) : Action(name, 0, pSocket) {}
+		/*!
+		Release bytes (or connections) handled and rearms a reception paused by the IOSocket thread if limit is no more reached,
+		pWeakSocket is the subscription key given by the reactor thread (just compared, never dereferenced) */
+		static void Release(Socket& socket, uint32_t count, uint32_t limit, Weak<Socket>* pWeakSocket, Resumption& resumption) {
+			if ((socket._receiving -= count) >= limit)
+				return;
+			uint8_t reading(1);
+			if (socket._reading.compare_exchange_strong(reading, 0))
+				resumption.push(pWeakSocket);
+		}
+	};
+	struct Received : Reception {
+		Received(const Shared<Socket>& pSocket, Shared<Buffer>& pBuffer, const SocketAddress& address, Weak<Socket>* pWeakSocket, const Shared<Resumption>& pResumption) :
+			Reception("SocketReceive", pSocket), _pBuffer(move(pBuffer)), _address(address), _pWeakSocket(pWeakSocket), _pResumption(pResumption) {}
+	private:
+		struct Handle : Action::Handle {
+			Handle(const char* name, const Shared<Socket>& pSocket, const Exception& ex, Shared<Buffer>& pBuffer, const SocketAddress& address, uint32_t size, Weak<Socket>* pWeakSocket, const Shared<Resumption>& pResumption) :
+				Action::Handle(name, pSocket, ex), _pBuffer(move(pBuffer)), _address(address), _size(size), _pWeakSocket(pWeakSocket), _pResumption(pResumption) {}
+		private:
+			void handle(const Shared<Socket>& pSocket) {
+				pSocket->_onReceived(_pBuffer, _address);
+				Release(*pSocket, _size, pSocket->recvBufferSize(), _pWeakSocket, *_pResumption);
+			}
+			Shared<Buffer>		_pBuffer;
+			SocketAddress		_address;
+			uint32_t			_size;
+			Weak<Socket>*		_pWeakSocket;
+			Shared<Resumption>	_pResumption;
+		};
+		bool process(Exception& ex, const Shared<Socket>& pSocket) {
+			uint32_t size(_pBuffer->size());
+			// decode can't happen BEFORE onDisconnection because this call decode + push to _handler in this call!
+			if (pSocket->_pDecoder)
+				pSocket->_pDecoder->decode(_pBuffer, _address, pSocket);
+			if (_pBuffer)
+				handle<Handle>(pSocket, _pBuffer, _address, size, _pWeakSocket, _pResumption);
+			else
+				Release(*pSocket, size, pSocket->recvBufferSize(), _pWeakSocket, *_pResumption);
+			return true;
+		}
+		Shared<Buffer>		_pBuffer;
+		SocketAddress		_address;
+		Weak<Socket>*		_pWeakSocket;
+		Shared<Resumption>	_pResumption;
+	};
+	struct Accepted : Reception {
+		Accepted(const Shared<Socket>& pSocket, NET_SOCKET sockfd, Weak<Socket>* pWeakSocket, const Shared<Resumption>& pResumption) :
+			Reception("SocketAccept", pSocket), _sockfd(sockfd), _pWeakSocket(pWeakSocket), _pResumption(pResumption) {}
+		~Accepted() {
+			if (_sockfd != NET_INVALID_SOCKET)
+				NET_CLOSESOCKET(_sockfd);
+		}
+	private:
+		struct Handle : Action::Handle {
+			Handle(const char* name, const Shared<Socket>& pSocket, const Exception& ex, Shared<Socket>& pConnection, Weak<Socket>* pWeakSocket, const Shared<Resumption>& pResumption) :
+				Action::Handle(name, pSocket, ex), _pConnection(move(pConnection)), _pWeakSocket(pWeakSocket), _pResumption(pResumption) {}
+		private:
+			void handle(const Shared<Socket>& pSocket) {
+				pSocket->_onAccept(_pConnection);
+				Release(*pSocket, 1, Socket::BACKLOG_MAX, _pWeakSocket, *_pResumption);
+			}
+			Shared<Socket>		_pConnection;
+			Weak<Socket>*		_pWeakSocket;
+			Shared<Resumption>	_pResumption;
+		};
+		bool process(Exception& ex, const Shared<Socket>& pSocket) {
+			union {
+				struct sockaddr_in  sa_in;
+				struct sockaddr_in6 sa_in6;
+			} addr;
+			NET_SOCKLEN addrSize = sizeof(addr);
+			Shared<Socket> pConnection;
+			if (getpeername(_sockfd, (sockaddr*)&addr, &addrSize) == 0)
+				pConnection = pSocket->newSocket(ex, _sockfd, (sockaddr&)addr);
+			else
+				Socket::SetException(ex);
+			if (!pConnection) {
+				Release(*pSocket, 1, Socket::BACKLOG_MAX, _pWeakSocket, *_pResumption);
+				return false;
+			}
+			_sockfd = NET_INVALID_SOCKET; // owned by pConnection now
+			handle<Handle>(pSocket, pConnection, _pWeakSocket, _pResumption);
+			return true;
+		}
+		NET_SOCKET			_sockfd;
+		Weak<Socket>*		_pWeakSocket;
+		Shared<Resumption>	_pResumption;
+	};
+
+	enum Mode : uint8_t {
+		MODE_READINESS = 0, // EPOLLIN => IOSocket::read (secure sockets or fallback)
+		MODE_RECV, // multishot recv with provided buffers (stream)
+		MODE_RECVMSG, // multishot recvmsg with provided buffers (datagram)
+		MODE_ACCEPT // multishot accept
+	};
+	struct Subscription {
+		Subscription() : mode(MODE_READINESS), requests(0), removed(false), polling(false), receiving(false), ended(false) {}
+		Mode	mode;
+		uint8_t	requests; // requests in progress (poll and reception)
+		bool	removed;
+		bool	polling;
+		bool	receiving;
+		bool	ended;
+	};
+	unordered_map<Weak<Socket>*, Subscription> subscriptions;
+
+	// msghdr template used by multishot recvmsg, must stay alive while requests are in progress
+	msghdr header;
+	memset(&header, 0, sizeof(header));
+	header.msg_namelen = sizeof(sockaddr_in6);
+
+	auto poll = [&](Weak<Socket>* pWeakSocket, Subscription& subscription, Socket& socket) {
+		io_uring_sqe& sqe(uring.sqe());
+		sqe.opcode = IORING_OP_POLL_ADD;
+		sqe.fd = socket;
+		sqe.len = IORING_POLL_ADD_MULTI;
+		sqe.poll32_events = EPOLLOUT | EPOLLRDHUP | EPOLLET;
+		if (subscription.mode == MODE_READINESS)
+			sqe.poll32_events |= EPOLLIN;
+		sqe.user_data = uintptr_t(pWeakSocket) | URING_POLL;
+		subscription.polling = true;
+		++subscription.requests;
+	};
+	auto cancel = [&](Weak<Socket>* pWeakSocket, uint8_t type) {
+		io_uring_sqe& sqe(uring.sqe());
+		sqe.opcode = IORING_OP_ASYNC_CANCEL;
+		sqe.fd = -1;
+		sqe.addr = uintptr_t(pWeakSocket) | type;
+		sqe.cancel_flags = IORING_ASYNC_CANCEL_ALL;
+		sqe.user_data = 0; // ignored completion
+	};
+	auto receive = [&](Weak<Socket>* pWeakSocket, Subscription& subscription, Socket& socket) {
+		if (subscription.receiving || subscription.ended || subscription.mode == MODE_READINESS || socket._reading)
+			return;
+		// backpressure, pause reception while too much data are waiting to be handled
+		uint32_t limit(subscription.mode == MODE_ACCEPT ? uint32_t(Socket::BACKLOG_MAX) : socket.recvBufferSize());
+		if (socket._receiving >= limit) {
+			uint8_t reading(0);
+			if (!socket._reading.compare_exchange_strong(reading, 1))
+				return;
+			if (socket._receiving >= limit)
+				return; // Reception::Release will resume it
+			reading = 1;
+			if (!socket._reading.compare_exchange_strong(reading, 0))
+				return;
+		}
+		io_uring_sqe& sqe(uring.sqe());
+		sqe.fd = socket;
+		switch (subscription.mode) {
+			case MODE_ACCEPT:
+				sqe.opcode = IORING_OP_ACCEPT;
+				sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+				sqe.user_data = uintptr_t(pWeakSocket) | URING_ACCEPT;
+				break;
+			case MODE_RECVMSG:
+				sqe.opcode = IORING_OP_RECVMSG;
+				sqe.addr = uintptr_t(&header);
+				sqe.len = 1;
+				sqe.ioprio = IORING_RECV_MULTISHOT;
+				sqe.flags = IOSQE_BUFFER_SELECT;
+				sqe.buf_group = URING_GROUP_DATAGRAM;
+				sqe.user_data = uintptr_t(pWeakSocket) | URING_DATAGRAM;
+				break;
+			default:
+				sqe.opcode = IORING_OP_RECV;
+				sqe.ioprio = IORING_RECV_MULTISHOT;
+				sqe.flags = IOSQE_BUFFER_SELECT;
+				sqe.buf_group = URING_GROUP_STREAM;
+				sqe.user_data = uintptr_t(pWeakSocket) | URING_STREAM;
+		}
+		subscription.receiving = true;
+		++subscription.requests;
+	};
+	// Unsupported reception request (or secure socket) => rather EPOLLIN readiness and IOSocket::read as epoll engine
+	auto fallback = [&](Weak<Socket>* pWeakSocket, Subscription& subscription, Socket& socket) {
+		if (subscription.mode == MODE_READINESS)
+			return;
+		if (subscription.receiving)
+			cancel(pWeakSocket, subscription.mode == MODE_ACCEPT ? URING_ACCEPT : (subscription.mode == MODE_RECVMSG ? URING_DATAGRAM : URING_STREAM));
+		subscription.mode = MODE_READINESS;
+		if (subscription.polling)
+			cancel(pWeakSocket, URING_POLL); // rearmed on ECANCELED with EPOLLIN
+		else
+			poll(pWeakSocket, subscription, socket);
+		uint8_t reading(1);
+		socket._reading.compare_exchange_strong(reading, 0);
+	};
+
+	bool terminate(false);
+	auto onMessage = [&](uintptr_t message) {
+		Weak<Socket>* pWeakSocket(reinterpret_cast<Weak<Socket>*>(message & ~uintptr_t(URING_MASK)));
+		switch (message & URING_MASK) {
+			case URING_ADD: {
+				Shared<Socket> pSocket(pWeakSocket->lock());
+				if (!pSocket)
+					break; // socket dies, wait its removing
+				Subscription& subscription(subscriptions[pWeakSocket]);
+				if (pSocket->listening())
+					subscription.mode = MODE_ACCEPT;
+				else if (pSocket->isSecure())
+					subscription.mode = MODE_READINESS;
+				else
+					subscription.mode = pSocket->type == Socket::TYPE_DATAGRAM ? MODE_RECVMSG : MODE_RECV;
+				poll(pWeakSocket, subscription, *pSocket);
+				if (subscription.mode != MODE_RECV) // stream reception is armed on first EPOLLOUT (connection)
+					receive(pWeakSocket, subscription, *pSocket);
+				break;
+			}
+			case URING_RESUME: {
+				auto it = subscriptions.find(pWeakSocket);
+				if (it == subscriptions.end() || it->second.removed)
+					break;
+				Shared<Socket> pSocket(pWeakSocket->lock());
+				if (pSocket)
+					receive(pWeakSocket, it->second, *pSocket);
+				break;
+			}
+			default: { // URING_REMOVE
+				auto it = subscriptions.find(pWeakSocket);
+				if (it == subscriptions.end()) {
+					delete pWeakSocket;
+					break;
+				}
+				it->second.removed = true;
+				if (!it->second.requests) {
+					subscriptions.erase(it);
+					delete pWeakSocket;
+					break;
+				}
+				cancel(pWeakSocket, URING_POLL);
+				if (it->second.receiving)
+					cancel(pWeakSocket, it->second.mode == MODE_ACCEPT ? URING_ACCEPT : (it->second.mode == MODE_RECVMSG ? URING_DATAGRAM : URING_STREAM));
+			}
+		}
+	};
+
+	// eventfd to get the receptions to resume
+	auto resumptions = [&]() {
+		io_uring_sqe& sqe(uring.sqe());
+		sqe.opcode = IORING_OP_POLL_ADD;
+		sqe.fd = pResumption->fd;
+		sqe.len = IORING_POLL_ADD_MULTI;
+		sqe.poll32_events = EPOLLIN;
+		sqe.user_data = URING_RESUMPTION;
+	};
+
+	auto onCompletion = [&](const io_uring_cqe& cqe) {
+		if (!cqe.user_data)
+			return; // cancel request
+		uint8_t type(cqe.user_data & URING_MASK);
+		uint16_t group(type == URING_DATAGRAM ? URING_GROUP_DATAGRAM : URING_GROUP_STREAM);
+		if (type == URING_PIPE) {
+			if (cqe.res < 0 || (cqe.res & (EPOLLHUP | EPOLLERR))) {
+				terminate = true; // termination signal on IOSocket deletion
+				return;
+			}
+			uintptr_t message;
+			while (::read(readFD, &message, sizeof(message)) > 0)
+				onMessage(message);
+			if (!(cqe.flags & IORING_CQE_F_MORE)) {
+				io_uring_sqe& sqe(uring.sqe());
+				sqe.opcode = IORING_OP_POLL_ADD;
+				sqe.fd = readFD;
+				sqe.len = IORING_POLL_ADD_MULTI;
+				sqe.poll32_events = EPOLLIN;
+				sqe.user_data = URING_PIPE;
+			}
+			return;
+		}
+		if (type == URING_RESUMPTION) {
+			vector<Weak<Socket>*> sockets;
+			for (Weak<Socket>* pWeakSocket : pResumption->pop(sockets))
+				onMessage(uintptr_t(pWeakSocket) | URING_RESUME);
+			if (!(cqe.flags & IORING_CQE_F_MORE))
+				resumptions();
+			return;
+		}
+
+		Weak<Socket>* pWeakSocket(reinterpret_cast<Weak<Socket>*>(cqe.user_data & ~uint64_t(URING_MASK)));
+		auto it = subscriptions.find(pWeakSocket);
+		if (it == subscriptions.end()) {
+			uring.recycle(cqe, group);
+			return;
+		}
+		Subscription& subscription(it->second);
+		if (!(cqe.flags & IORING_CQE_F_MORE)) {
+			--subscription.requests;
+			if (type == URING_POLL)
+				subscription.polling = false;
+			else
+				subscription.receiving = false;
+		}
+		Shared<Socket> pSocket;
+		if (!subscription.removed)
+			pSocket = pWeakSocket->lock();
+		if (!pSocket) {
+			uring.recycle(cqe, group);
+			if (type == URING_ACCEPT && cqe.res >= 0)
+				NET_CLOSESOCKET(cqe.res);
+			if (subscription.removed && !subscription.requests) {
+				subscriptions.erase(it);
+				delete pWeakSocket;
+			}
+			return;
+		}
+
+		if (type == URING_POLL) {
+			if (cqe.res < 0) {
+				if (cqe.res != -ECANCELED)
+					threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", -cqe.res, pSocket);
+				else if (!subscription.polling)
+					poll(pWeakSocket, subscription, *pSocket); // rearm with the new mode
+				return;
+			}
+			if (!subscription.polling)
+				poll(pWeakSocket, subscription, *pSocket);
+			// EPOLLIN | EPOLLOUT | EPOLLERR | EPOLLHUP | EPOLLRDHUP
+			int error = 0;
+			if (cqe.res&EPOLLERR) {
+				socklen_t len(sizeof(error));
+				if (getsockopt(pSocket->id(), SOL_SOCKET, SO_ERROR, (void *)&error, &len) == -1)
+					error = Net::LastError();
+			}
+			if (cqe.res&EPOLLRDHUP) {
+				// disconnection, wait the end of multishot reception if armed to not lost the last data
+				if (subscription.mode != MODE_RECV || !subscription.receiving || error) {
+					subscription.ended = true;
+					close(pSocket, error);
+				}
+				return;
+			}
+			if (!(cqe.res&EPOLLHUP)) { // if socket unexpected close no more read or write!
+				// EPOLLOUT in first to get the onFlush (onConnection for TCP) in first (before any reception)
+				if (cqe.res&EPOLLOUT) {
+					write(pSocket, error);
+					error = 0;
+					receive(pWeakSocket, subscription, *pSocket);
+				}
+				if ((cqe.res&EPOLLIN) && subscription.mode == MODE_READINESS) {
+					read(pSocket, error);
+					error = 0;
+				}
+			}
+			if (error) // on few unix system we can get an error without anything else
+				threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", error, pSocket);
+			return;
+		}
+
+		if (cqe.res < 0) {
+			uring.recycle(cqe, group);
+			switch (-cqe.res) {
+				case ECANCELED:
+				case ENOBUFS: // no more provided buffer, rearm
+					break;
+				case EINVAL:
+				case EOPNOTSUPP:
+					fallback(pWeakSocket, subscription, *pSocket);
+					return;
+				case ENOTCONN:
+					if (type == URING_STREAM)
+						return; // wait EPOLLOUT (connection)
+				default:
+					threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", -cqe.res, pSocket);
+					if (type == URING_ACCEPT)
+						fallback(pWeakSocket, subscription, *pSocket);
+					else if (type == URING_STREAM)
+						subscription.ended = true;
+			}
+		} else if (type == URING_ACCEPT) {
+			++pSocket->_receiving;
+			threadPool.queue<Accepted>(pSocket->_threadReceive, pSocket, cqe.res, pWeakSocket, pResumption);
+		} else if (!cqe.res && type == URING_STREAM) {
+			// a recv returns 0 without any error can happen on TCP socket one time disconnected!
+			uring.recycle(cqe, group);
+			if (!subscription.ended) {
+				subscription.ended = true;
+				close(pSocket, 0);
+			}
+			return;
+		} else if (cqe.flags & IORING_CQE_F_BUFFER) {
+			const char* data(uring.buffer(cqe, group).data());
+			uint32_t offset(0), size(cqe.res);
+			bool truncated(false);
+			SocketAddress address;
+			if (type == URING_DATAGRAM) {
+				const io_uring_recvmsg_out& out(*(const io_uring_recvmsg_out*)data);
+				if (out.namelen <= header.msg_namelen)
+					address.set(*(const sockaddr*)(data + sizeof(out)));
+				offset = sizeof(out) + header.msg_namelen + header.msg_controllen;
+				size = out.payloadlen;
+				truncated = (out.flags & MSG_TRUNC) ? true : false;
+			} else
+				address = pSocket->peerAddress();
+			if (truncated) {
+				// UDP packet lost, larger than max UDP size (IPv6 jumbogram)
+				uring.recycle(cqe, group);
+				threadPool.queue<Action>(pSocket->_threadReceive, "SocketError", NET_EMSGSIZE, pSocket);
+			} else {
+				Shared<Buffer> pBuffer;
+				if (size > URING_COPYBREAK) {
+					// delivered without copy, a new pooled buffer replaces it in kernel
+					pBuffer = uring.release(cqe, group);
+					pBuffer->clip(offset).resize(size);
+				} else {
+					pBuffer.set(data + offset, size);
+					uring.recycle(cqe, group);
+				}
+				pSocket->receive(size);
+				if (!pSocket->_address)
+					pSocket->_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+				pSocket->_receiving += size;
+				threadPool.queue<Received>(pSocket->_threadReceive, pSocket, pBuffer, address, pWeakSocket, pResumption);
+			}
+		}
+
+		if (cqe.flags & IORING_CQE_F_MORE) {
+			// backpressure, pause reception while too much data are waiting to be handled
+			uint32_t limit(type == URING_ACCEPT ? uint32_t(Socket::BACKLOG_MAX) : pSocket->recvBufferSize());
+			if (pSocket->_receiving < limit)
+				return;
+			uint8_t reading(0);
+			if (!pSocket->_reading.compare_exchange_strong(reading, 1))
+				return;
+			if (pSocket->_receiving >= limit) {
+				cancel(pWeakSocket, type);
+				return;
+			}
+			reading = 1;
+			pSocket->_reading.compare_exchange_strong(reading, 0);
+			return;
+		}
+		receive(pWeakSocket, subscription, *pSocket); // rearm
+	};
+
+	// pipe to get subscriptions and IOSocket termination
+	io_uring_sqe& sqe(uring.sqe());
+	sqe.opcode = IORING_OP_POLL_ADD;
+	sqe.fd = readFD;
+	sqe.len = IORING_POLL_ADD_MULTI;
+	sqe.poll32_events = EPOLLIN;
+	sqe.user_data = URING_PIPE;
+	resumptions();
+
+	int result(0);
+	for (;;) {
+		result = uring.submit(1);
+		if (result < 0 && result != -EINTR && result != -EBUSY && result != -EAGAIN)
+			break;
+		result = 0;
+		Time::Tick(); // refresh Time::Coarse() for these completions
+		uring.completions(onCompletion);
+		if (terminate)
+			break; // termination signal on IOSocket deletion
+
+		if (!_subscribers) {
+			lock_guard<mutex> lock(_mutex);
+			// no more socket to manage?
+			if (!_subscribers)
+				break;
+		}
+	}
+
+	pResumption->close(); // late Reception::Release becomes a no-op
+
+	// remove sockets
+	uintptr_t message;
+	while (::read(readFD, &message, sizeof(message)) > 0) {
+		if (!(message & URING_MASK))
+			onMessage(message);
+	}
+	for (auto& it : subscriptions) {
+		if (it.second.removed)
+			delete it.first;
+	}
+	::close(readFD);  // close reader pipe side
+	
+	if (result < 0) { // error
+		ex.set<Ex::Net::System>("impossible to manage sockets (error ", -result, ")");
+		return false;
+	}
+	if (terminate && _subscribers) {
+		ex.set<Ex::Net::System>("dies with remaining sockets managed");
+		return false;
+	}
+	if (!terminate) {
+		lock_guard<mutex> lock(_mutex);
+		stop(); // to set running=false!
+	}
+	return true;
+}
+#endif
 	
 void IOSocket::stop() {
 #if defined(SRT_API)
 	if (_pIOSRTSocket)
 		_pIOSRTSocket->stop();
 #endif
+	for (Unique<IOSocket>& pReactor : _reactors)
+		pReactor->stop();
 	Thread::stop();
 }
 
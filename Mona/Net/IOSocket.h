@@ -25,14 +25,38 @@ details (or else see http://mozilla.org/MPL/2.0/).
 namespace Mona {
 
 struct IOSRTSocket;
+struct IOUring;
 struct IOSocket : protected Thread, virtual Object {
-	IOSocket(const Handler& handler, const ThreadPool& threadPool);
+	enum Engine {
+		ENGINE_DEFAULT = 0, // epoll on Linux, kqueue on BSD, WSAAsyncSelect on Windows
+		ENGINE_URING // io_uring on Linux with multishot recv/accept (sendings stay on send syscalls), fallbacks to ENGINE_DEFAULT if unsupported by the system
+	};
+	enum Balancing {
+		BALANCING_LOAD = 0, // subscribe socket to the reactor which manages the less sockets
+		BALANCING_HASH // subscribe socket to the reactor computed from its id
+	};
+	/*!
+	reactors > 1 shards sockets over several event threads (one epoll/kqueue by thread),
+	received/sent data continue to be dispatched to the same threadPool and handler */
+	IOSocket(const Handler& handler, const ThreadPool& threadPool, uint16_t reactors = 1, Balancing balancing = BALANCING_LOAD, Engine engine = ENGINE_DEFAULT);
+	IOSocket(const Handler& handler, const ThreadPool& threadPool, Engine engine, uint16_t reactors = 1, Balancing balancing = BALANCING_LOAD) :
+		IOSocket(handler, threadPool, reactors, balancing, engine) {}
 	~IOSocket();
 
 	const Handler&			handler;
 	const ThreadPool&		threadPool;
 
-	uint32_t					subscribers() const { return _subscribers; }
+	uint16_t					reactors() const { return uint16_t(_reactors.size() + 1); }
+	/*!
+	Engine used, can become ENGINE_DEFAULT after the first subscription if the engine requested is unsupported */
+	Engine					engine() const { return _engine; }
+	uint32_t					subscribers() const;
+	/*!
+	Metrics aggregated over all the sockets subscribed (also after their unsubscription) */
+	const Socket::Aggregate&	aggregate() const { return *_pAggregate; }
+	/*!
+	Write sockets, traffic and queueing metrics */
+	void					collect(Metrics::Writer& writer, const std::string& prefix = "mona_net") const;
 
 	bool					subscribe(Exception& ex, const Shared<Socket>& pSocket,
 								const Socket::OnReceived& onReceived,
@@ -97,6 +121,11 @@ private:
 	
 	virtual bool run(Exception& ex, const volatile bool& requestStop);
 
+	uint16_t	 reactor(const Socket& socket) const;
+#if !defined(_WIN32)
+	bool		 runURing(Exception& ex, IOUring& uring, int readFD);
+#endif
+
 #if defined(_WIN32)
 	std::map<NET_SOCKET, Weak<Socket>>	_sockets;
 	std::mutex									_mutexSockets;
@@ -106,6 +135,10 @@ private:
 
 	NET_SYSTEM									_system;
 	Shared<IOSRTSocket>							_pIOSRTSocket;
+	std::vector<Unique<IOSocket>>				_reactors; // additional reactors, this one is the reactor 0
+	Balancing									_balancing;
+	std::atomic<Engine>							_engine;
+	const Shared<Socket::Aggregate>				_pAggregate;
 
 	struct Action;
 };
@@ -0,0 +1,200 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Net/IOUring.h"
+
+#if defined(URING_API)
+
+#include "Mona/Memory/Buffer.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace Mona {
+
+IOUring::IOUring() : _fd(-1), _sqes(NULL), _sqesSize(0), _sqTail(0) {
+	memset(&_sq, 0, sizeof(_sq));
+	memset(&_cq, 0, sizeof(_cq));
+}
+
+IOUring::~IOUring() {
+	if (_sqes)
+		munmap(_sqes, _sqesSize);
+	if (_sq.ring)
+		munmap(_sq.ring, _sq.size);
+	if (_fd >= 0)
+		::close(_fd);
+	// buffers are released after the ring closing (no more kernel access)
+}
+
+bool IOUring::init(Exception& ex, uint32_t entries) {
+	io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	// multishot requests can produce a lot of completions for one submission
+	params.flags = IORING_SETUP_CQSIZE;
+	params.cq_entries = entries * 4;
+#if defined(IORING_SETUP_SINGLE_ISSUER)
+	params.flags |= IORING_SETUP_SINGLE_ISSUER;
+#endif
+#if defined(IORING_SETUP_COOP_TASKRUN)
+	params.flags |= IORING_SETUP_COOP_TASKRUN;
+#endif
+	_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+	if (_fd < 0 && errno == EINVAL) {
+		// older kernel, retry without optional flags
+		memset(&params, 0, sizeof(params));
+		params.flags = IORING_SETUP_CQSIZE;
+		params.cq_entries = entries * 4;
+		_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+	}
+	if (_fd < 0) {
+		ex.set<Ex::Unsupported>("io_uring setup, ", strerror(errno));
+		return false;
+	}
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+		ex.set<Ex::Unsupported>("io_uring without single mmap feature, kernel too old");
+		return false;
+	}
+
+	_sq.size = max(params.sq_off.array + params.sq_entries * sizeof(uint32_t), params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+	_sq.ring = mmap(NULL, _sq.size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+	if (_sq.ring == MAP_FAILED) {
+		_sq.ring = NULL;
+		ex.set<Ex::System::Memory>("io_uring rings mapping, ", strerror(errno));
+		return false;
+	}
+	_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+	_sqes = (io_uring_sqe*)mmap(NULL, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+	if (_sqes == MAP_FAILED) {
+		_sqes = NULL;
+		ex.set<Ex::System::Memory>("io_uring SQEs mapping, ", strerror(errno));
+		return false;
+	}
+
+	char* ring = (char*)_sq.ring;
+	_sq.head = (uint32_t*)(ring + params.sq_off.head);
+	_sq.tail = (uint32_t*)(ring + params.sq_off.tail);
+	_sq.mask = *(uint32_t*)(ring + params.sq_off.ring_mask);
+	_sq.entries = *(uint32_t*)(ring + params.sq_off.ring_entries);
+	_sq.array = (uint32_t*)(ring + params.sq_off.array);
+	_sqTail = *_sq.tail;
+	// single mmap => CQ ring shares the SQ ring mapping
+	_cq.head = (uint32_t*)(ring + params.cq_off.head);
+	_cq.tail = (uint32_t*)(ring + params.cq_off.tail);
+	_cq.mask = *(uint32_t*)(ring + params.cq_off.ring_mask);
+	_cq.cqes = (io_uring_cqe*)(ring + params.cq_off.cqes);
+	return true;
+}
+
+io_uring_sqe& IOUring::sqe() {
+	if (_backlog.empty() && pending() >= _sq.entries)
+		submit(); // full, push pending SQEs to the kernel to get place
+	if (!_backlog.empty() || pending() >= _sq.entries) {
+		// kernel has consumed nothing, don't overwrite its SQEs
+		_backlog.emplace_back();
+		memset(&_backlog.back(), 0, sizeof(io_uring_sqe));
+		return _backlog.back();
+	}
+	uint32_t index(_sqTail++ & _sq.mask);
+	_sq.array[index] = index;
+	io_uring_sqe& sqe(_sqes[index]);
+	memset(&sqe, 0, sizeof(sqe));
+	return sqe;
+}
+
+int IOUring::submit(uint32_t wait) {
+	while (!_backlog.empty() && pending() < _sq.entries) {
+		uint32_t index(_sqTail++ & _sq.mask);
+		_sq.array[index] = index;
+		_sqes[index] = _backlog.front();
+		_backlog.pop_front();
+	}
+	atomic_store_explicit((atomic<uint32_t>*)_sq.tail, _sqTail, memory_order_release);
+	// SQEs not consumed by kernel, including ones published by a previous enter which has failed
+	uint32_t count(pending());
+	if (!count && !wait)
+		return 0;
+	int result = (int)syscall(__NR_io_uring_enter, _fd, count, wait, wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	if (result >= 0)
+		return result;
+	result = -errno;
+	if (!wait || (result != -EBUSY && result != -EAGAIN))
+		return result;
+	// completion queue overflowed (or no memory to submit) => just wait completions to reap, SQEs are submitted on next call
+	result = (int)syscall(__NR_io_uring_enter, _fd, 0, wait, IORING_ENTER_GETEVENTS, NULL, 0);
+	return result < 0 ? -errno : 0;
+}
+
+bool IOUring::addBuffers(Exception& ex, uint16_t group, uint16_t count, uint32_t size) {
+	if (group >= _groups.size())
+		_groups.resize(group + 1);
+	Group& buffers(_groups[group]);
+	if (!buffers.buffers.empty()) {
+		ex.set<Ex::Intern>("io_uring buffers group ", group, " already registered");
+		return false;
+	}
+	// Provide buffers with IORING_OP_PROVIDE_BUFFERS rather than a mapped buffer ring (IORING_REGISTER_PBUF_RING),
+	// supported since 5.7 and reliable with multishot requests on all kernels tested,
+	// one pooled Buffer by id to deliver it without copy (see release)
+	buffers.size = size;
+	buffers.buffers.resize(count);
+	for (uint16_t id = 0; id < count; ++id)
+		provide(group, id);
+	int result(0);
+	uint32_t done(0);
+	while (done < count && (result = submit(count - done)) >= 0) {
+		done += completions([&result](const io_uring_cqe& cqe) {
+			if (!cqe.user_data && cqe.res < 0)
+				result = cqe.res;
+		});
+		if (result < 0)
+			break;
+	}
+	if (result >= 0)
+		return true;
+	ex.set<Ex::Unsupported>("io_uring provided buffers, ", strerror(-result));
+	return false;
+}
+
+Shared<Buffer> IOUring::release(const io_uring_cqe& cqe, uint16_t group) {
+	Shared<Buffer> pBuffer;
+	if (!(cqe.flags & IORING_CQE_F_BUFFER))
+		return pBuffer;
+	uint16_t id(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+	pBuffer = move(_groups[group].buffers[id]);
+	provide(group, id); // allocates a new one
+	return pBuffer;
+}
+
+void IOUring::provide(uint16_t group, uint16_t id) {
+	Group& buffers(_groups[group]);
+	Shared<Buffer>& pBuffer(buffers.buffers[id]);
+	BUFFER_RESET(pBuffer, buffers.size);
+	io_uring_sqe& sqe(this->sqe());
+	sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+	sqe.fd = 1;
+	sqe.addr = uintptr_t(pBuffer->data());
+	sqe.len = buffers.size;
+	sqe.buf_group = group;
+	sqe.off = id;
+	sqe.user_data = 0; // completion to ignore
+}
+
+} // namespace Mona
+
+#endif
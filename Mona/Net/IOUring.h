@@ -0,0 +1,124 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Util/Exceptions.h"
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#if defined(IORING_RECV_MULTISHOT) && defined(IORING_ACCEPT_MULTISHOT)
+#define URING_API 1 // kernel headers >= 6.0 (multishot recv/accept)
+#endif
+#endif
+#endif
+
+#if defined(URING_API)
+
+#include "Mona/Memory/Buffer.h"
+#include <atomic>
+#include <deque>
+#include <vector>
+
+namespace Mona {
+
+/*!
+Minimal io_uring wrapper (raw syscalls, no liburing dependency) with provided buffers allocated by Buffer::Allocator,
+/!\ not thread-safe, SQEs and CQEs have to be managed by the same thread
+/!\ reception only: sendings stay on Socket::send/flush syscalls of the caller thread (multishot poll gives writability) */
+struct IOUring : virtual Object {
+	IOUring();
+	~IOUring();
+
+	int				fd() const { return _fd; }
+
+	bool			init(Exception& ex, uint32_t entries);
+
+	/*!
+	Get a zeroed SQE to fill, submits pending SQEs if submission queue is full,
+	and keeps it aside for the next submit if kernel has not consumed any place (EBUSY/EAGAIN) */
+	io_uring_sqe&	sqe();
+	/*!
+	Submit pending SQEs and wait at least 'wait' completions, returns -errno on error */
+	int				submit(uint32_t wait = 0);
+	/*!
+	Call onCompletion(const io_uring_cqe&) for each completion available, returns number of completions */
+	template<typename OnCompletion>
+	uint32_t completions(OnCompletion&& onCompletion) {
+		uint32_t head(*_cq.head);
+		uint32_t tail(std::atomic_load_explicit((std::atomic<uint32_t>*)_cq.tail, std::memory_order_acquire));
+		uint32_t count(tail - head);
+		while (head != tail)
+			onCompletion(_cq.cqes[head++ & _cq.mask]);
+		std::atomic_store_explicit((std::atomic<uint32_t>*)_cq.head, head, std::memory_order_release);
+		return count;
+	}
+
+	/*!
+	Register a group of pooled buffers which can be selected by kernel on reception (IOSQE_BUFFER_SELECT),
+	to call before any other request (waits its own completions) */
+	bool			addBuffers(Exception& ex, uint16_t group, uint16_t count, uint32_t size);
+	/*!
+	Buffer selected by this completion (IORING_CQE_F_BUFFER), keeps the size of the group */
+	const Buffer&	buffer(const io_uring_cqe& cqe, uint16_t group) const { return *_groups[group].buffers[uint16_t(cqe.flags >> IORING_CQE_BUFFER_SHIFT)]; }
+	/*!
+	Take the buffer selected by this completion to deliver it without copy, a new pooled buffer replaces it in kernel */
+	Shared<Buffer>	release(const io_uring_cqe& cqe, uint16_t group);
+	/*!
+	Give back to kernel the buffer selected by this completion, if any */
+	void			recycle(const io_uring_cqe& cqe, uint16_t group) { if (cqe.flags & IORING_CQE_F_BUFFER) provide(group, uint16_t(cqe.flags >> IORING_CQE_BUFFER_SHIFT)); }
+
+private:
+	struct Group {
+		Group() : size(0) {}
+		std::vector<Shared<Buffer>>	buffers; // buffer id => buffers[id]
+		uint32_t					size; // size of one buffer
+	};
+	/*!
+	Give a buffer to kernel (pending SQE with a null user_data) */
+	void				provide(uint16_t group, uint16_t id);
+	uint32_t			pending() const { return _sqTail - std::atomic_load_explicit((std::atomic<uint32_t>*)_sq.head, std::memory_order_acquire); }
+
+	int					_fd;
+	struct {
+		uint32_t*			head;
+		uint32_t*			tail;
+		uint32_t			mask;
+		uint32_t			entries;
+		uint32_t*			array;
+		void*				ring;
+		size_t				size;
+	}					_sq;
+	struct {
+		uint32_t*			head;
+		uint32_t*			tail;
+		uint32_t			mask;
+		io_uring_cqe*		cqes;
+		void*				ring;
+		size_t				size;
+	}					_cq;
+	io_uring_sqe*		_sqes;
+	size_t				_sqesSize;
+	uint32_t			_sqTail;
+	std::deque<io_uring_sqe>	_backlog; // SQEs waiting a place in the full submission queue
+	std::vector<Group>	_groups;
+};
+
+
+} // namespace Mona
+
+#endif
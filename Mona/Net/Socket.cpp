@@ -19,6 +19,15 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #if !defined(_WIN32)
 #include <net/if.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <sys/uio.h>
+#if !defined(IOV_MAX)
+#define IOV_MAX 16 // minimum guaranteed by POSIX
+#endif
+#endif
+#if defined(__linux__)
+#include <netinet/udp.h>
+#include <sys/sendfile.h>
 #endif
 
 
@@ -30,7 +39,7 @@ Socket::Socket(Type type) :
 #if !defined(_WIN32)
 	_pWeakThis(NULL), 
 #endif
-	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(0), _sendTime(0), _id(NET_INVALID_SOCKET), _threadReceive(0),
+	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _aggregate(NULL), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(0), _sendTime(0), _id(NET_INVALID_SOCKET), _threadReceive(0), _threadSend(0), _reactor(0),
 	onError(_onError) {
 
 	if (type < TYPE_OTHER) {
@@ -48,7 +57,7 @@ Socket::Socket(NET_SOCKET id, const sockaddr& addr, Type type) : _peerAddress(ad
 #if !defined(_WIN32)
 	_pWeakThis(NULL),
 #endif
-	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(Time::Now()), _sendTime(0), _id(id), _threadReceive(0),
+	_opened(false), _pDecoder(NULL), _externDecoder(false), _nonBlockingMode(false), _listening(false), _receiving(0), _queueing(0), _aggregate(NULL), _recvBufferSize(Net::GetRecvBufferSize()), _sendBufferSize(Net::GetSendBufferSize()), _reading(0), _sending(false), type(type), _recvTime(Time::Now()), _sendTime(0), _id(id), _threadReceive(0), _threadSend(0), _reactor(0),
 	onError(_onError) {
 
 	if (type < TYPE_OTHER)
@@ -59,6 +68,8 @@ Socket::Socket(NET_SOCKET id, const sockaddr& addr, Type type) : _peerAddress(ad
 
 
 Socket::~Socket() {
+	if (Aggregate* pAggregate = _aggregate)
+		pAggregate->queueing -= _queueing; // sendings lost
 	if (_externDecoder) {
 		_pDecoder->onRelease(self);
 		delete _pDecoder;
@@ -72,6 +83,10 @@ Socket::~Socket() {
 	flush(ignore, true);
 	close();
 	NET_CLOSESOCKET(_id);
+	if (_onFlushed) { // sendings lost
+		ignore.set<Ex::Net::Socket>("Socket deleted before flushing");
+		_onFlushed(ignore);
+	}
 }
 
 bool Socket::shutdown(Socket::ShutdownType type) {
@@ -482,7 +497,7 @@ int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& addr
 	lock_guard<mutex> lock(_mutexSending);
 	if(!_sendings.empty()) {
 		_sendings.emplace_back(packet, address ? address : _peerAddress, flags);
-		_queueing += packet.size();
+		addQueueing(packet.size());
 		return 0;
 	}
 	_sending = true;
@@ -506,19 +521,235 @@ int Socket::write(Exception& ex, const Packet& packet, const SocketAddress& addr
 	}
 
 	_sendings.emplace_back(packet+sent, address ? address : _peerAddress, flags);
-	_queueing += _sendings.back().size();
+	addQueueing(_sendings.back().size());
 	return sent;
 }
 
+void Socket::queue(const Packet& packet, const SocketAddress& address, int flags) {
+	lock_guard<mutex> lock(_mutexSending);
+	_sending = true;
+	_sendings.emplace_back(packet, address ? address : _peerAddress, flags);
+	addQueueing(packet.size());
+}
+
+#if !defined(_WIN32)
+static int SendV(NET_SOCKET id, iovec* iovecs, uint32_t count, const SocketAddress& address, int flags, int& error) {
+	msghdr header;
+	memset(&header, 0, sizeof(header));
+	if (address) {
+		header.msg_name = (void*)address.data();
+		header.msg_namelen = address.size();
+	}
+	header.msg_iov = iovecs;
+	header.msg_iovlen = count;
+#if defined(MSG_NOSIGNAL)
+	flags |= MSG_NOSIGNAL;
+#endif
+	int rc;
+	do {
+		rc = ::sendmsg(id, &header, flags);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+	return rc;
+}
+#endif
+
+int Socket::write(Exception& ex, initializer_list<Packet> packets, const SocketAddress& address, int flags) {
+	uint32_t size(0);
+	for (const Packet& packet : packets)
+		size += packet.size();
+	if (packets.size() < 2 || type != TYPE_STREAM || isEncrypting()
+#if defined(_WIN32)
+		|| true // no gathering
+#endif
+		) {
+		if (packets.size() == 1)
+			return write(ex, *packets.begin(), address, flags);
+		if (type == TYPE_STREAM && !isEncrypting()) {
+			// sequential writing
+			int sent(0);
+			for (const Packet& packet : packets) {
+				int rc = write(ex, packet, address, flags);
+				if (rc < 0)
+					return -1;
+				sent += rc;
+			}
+			return sent;
+		}
+		// one datagram (or one encrypted message), concatenate
+		Shared<Buffer> pBuffer(SET, size);
+		char* data(pBuffer->data());
+		for (const Packet& packet : packets) {
+			memcpy(data, packet.data(), packet.size());
+			data += packet.size();
+		}
+		return write(ex, Packet(pBuffer), address, flags);
+	}
+#if !defined(_WIN32)
+	lock_guard<mutex> lock(_mutexSending);
+	if (!_sendings.empty()) {
+		for (const Packet& packet : packets)
+			_sendings.emplace_back(packet, address ? address : _peerAddress, flags);
+		addQueueing(size);
+		return 0;
+	}
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+	_sending = true;
+	iovec iovecs[IOV_MAX];
+	uint32_t count(0);
+	for (const Packet& packet : packets) {
+		if (count == IOV_MAX)
+			break; // rest will be queued
+		iovecs[count].iov_base = (void*)packet.data();
+		iovecs[count++].iov_len = packet.size();
+	}
+	int error;
+	int sent = SendV(_id, iovecs, count, address, flags, error);
+	if (sent < 0) {
+		if ((error == NET_ENOTCONN && _peerAddress) || error == NET_EWOULDBLOCK) {
+			// queue and wait next call to flush(), no error!
+			sent = 0;
+		} else {
+			SetException(error, ex, " (address=", address ? address : _peerAddress, ", size=", size, ", flags=", flags, ", parts=", count, ")");
+			// RELIABILITY IMPOSSIBLE => shutdown system to avoid to try to send before shutdown!
+			close();
+			_sending = false;
+			return -1;
+		}
+	} else {
+		if (!_address)
+			_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+		send(sent);
+		if (uint32_t(sent) >= size) {
+			_sending = false;
+			return size;
+		}
+	}
+	// queue the rest, advancing across packet boundaries
+	uint32_t offset(sent);
+	for (const Packet& packet : packets) {
+		if (offset >= packet.size()) {
+			offset -= packet.size();
+			continue;
+		}
+		_sendings.emplace_back(packet + offset, address ? address : _peerAddress, flags);
+		addQueueing(_sendings.back().size());
+		offset = 0;
+	}
+	return sent;
+#endif
+}
+
+#if defined(__linux__)
+int64_t Socket::write(Exception& ex, int fd, uint64_t offset, uint64_t size, const Shared<const Object>& pOwner, int flags) {
+	if (type != TYPE_STREAM || isEncrypting()) {
+		ex.set<Ex::Intern>("Zero-copy file sending requires a not encrypting stream socket");
+		return -1;
+	}
+	lock_guard<mutex> lock(_mutexSending);
+	if (!_sendings.empty()) {
+		_sendings.emplace_back(fd, offset, size, pOwner, flags);
+		addQueueing(size);
+		return 0;
+	}
+	_sending = true;
+	int64_t sent = sendFile(ex, fd, offset, size);
+	if (sent < 0) {
+		int code = ex.cast<Ex::Net::Socket>().code;
+		if ((code == NET_ENOTCONN && _peerAddress) || code == NET_EWOULDBLOCK) {
+			// queue and wait next call to flush(), no error!
+			ex = nullptr;
+			sent = 0;
+		} else {
+			close(); // shutdown system to avoid to try to send before shutdown!
+			_sending = false;
+			return -1;
+		}
+	} else if (uint64_t(sent) >= size) {
+		_sending = false;
+		return size;
+	}
+	_sendings.emplace_back(fd, offset + sent, size - sent, pOwner, flags);
+	addQueueing(size - sent);
+	return sent;
+}
+
+int64_t Socket::sendFile(Exception& ex, int fd, uint64_t offset, uint64_t size) {
+	// returns size sent (can be partial if socket buffer is full), or -1 on error (NET_EWOULDBLOCK if nothing has been sent)
+	if (_ex) {
+		ex = _ex;
+		return -1;
+	}
+	off_t position(offset);
+	uint64_t rest(size);
+	while (rest) {
+		ssize_t rc = ::sendfile(_id, fd, &position, size_t(min<uint64_t>(rest, 0x7FFFF000u))); // max Linux transfer size
+		if (rc > 0) {
+			rest -= rc;
+			continue;
+		}
+		int error;
+		if (!rc)
+			error = EPIPE; // file truncated, end of file reached before end of sending
+		else if ((error = Net::LastError()) == NET_EINTR)
+			continue;
+		if (rest < size && error == NET_EWOULDBLOCK)
+			break; // partial
+		SetException(error, ex, " (file=", fd, ", offset=", position, ", size=", rest, ")");
+		return -1;
+	}
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+	send(uint32_t(size - rest));
+	return size - rest;
+}
+#endif
+
 bool Socket::flush(Exception& ex, bool deleting) {
-	uint32_t written(0);
+	uint64_t written(0);
 
 	unique_lock<mutex> lock(_mutexSending, defer_lock);
 	if (!deleting)
 		lock.lock();
 	int sent(0);
+#if defined(__linux__)
+	if (type == TYPE_DATAGRAM && !isSecure() && _sendings.size() > 1) {
+		// batch sending
+		while ((sent = sendDatagrams()) > 0)
+			written += sent;
+	}
+#endif
+#if !defined(_WIN32)
+	if (type == TYPE_STREAM && !isEncrypting()) {
+		// gathering sending
+		while ((sent = sendStream(ex, written)) > 0);
+		if (ex) {
+			// fail to send few reliable data, shutdown send!
+			close(); // shutdown system to avoid to try to send before shutdown!
+			flushed(lock, ex);
+			return false;
+		}
+	}
+#endif
 	while(sent>=0 && !_sendings.empty()) {
 		Sending& sending(_sendings.front());
+#if defined(__linux__)
+		if (sending.fd >= 0) {
+			// zero-copy file region
+			int64_t sentFile = sendFile(ex, sending.fd, sending.offset, sending.rest);
+			if (sentFile >= 0) {
+				written += sentFile;
+				sending.offset += sentFile;
+				if (sending.rest -= sentFile)
+					break; // can't send more!
+				_sendings.pop_front();
+				continue;
+			}
+			sent = -1;
+		} else
+#endif
 		sent = sendTo(ex, sending.data(), sending.size(), sending.address, sending.flags);
 		if (sent >= 0) {
 			written += sent;
@@ -536,16 +767,179 @@ bool Socket::flush(Exception& ex, bool deleting) {
 			} else if (type == TYPE_STREAM) {
 				// fail to send few reliable data, shutdown send!
 				close(); // shutdown system to avoid to try to send before shutdown!
+				flushed(lock, ex);
 				return false;
 			}
 		}
 		_sendings.pop_front();
 	}
-	if (!deleting && written && !(_queueing -= written))
+	if (!deleting && written && !addQueueing(-int64_t(written)))
 		_sending = false;
+	flushed(lock);
 	return true;
 }
 
+void Socket::flushed(unique_lock<mutex>& lock, const Exception& ex) {
+	if (!_onFlushed || (!ex && _queueing > _flushThreshold))
+		return;
+	function<void(const Exception&)> onFlushed(move(_onFlushed));
+	_onFlushed = nullptr;
+	if (lock)
+		lock.unlock();
+	onFlushed(ex);
+}
+
+void Socket::waitFlush(uint64_t threshold, function<void(const Exception&)>&& onFlushed) {
+	{
+		lock_guard<mutex> lock(_mutexSending);
+		DEBUG_ASSERT(!_onFlushed); // just one waiter at a time
+		if (_queueing > threshold) {
+			_flushThreshold = threshold;
+			_onFlushed = move(onFlushed);
+			return;
+		}
+	}
+	onFlushed(Exception());
+}
+
+#if !defined(_WIN32)
+int Socket::sendStream(Exception& ex, uint64_t& written) {
+	// Send queued packets in one sendmsg call, returns 1 to continue, 0 to continue with the standard sending, -1 if can't send more now (or error)
+	if (_ex || _sendings.size() < 2)
+		return 0; // use standard sending
+	iovec iovecs[IOV_MAX];
+	uint32_t count(0), size(0);
+	int flags(_sendings.front().flags);
+	for (const Sending& sending : _sendings) {
+		if (count == IOV_MAX || sending.flags != flags || sending.fd >= 0)
+			break;
+		iovecs[count].iov_base = (void*)sending.data();
+		iovecs[count++].iov_len = sending.size();
+		size += sending.size();
+	}
+	if (count < 2)
+		return 0;
+	int error;
+	int sent = SendV(_id, iovecs, count, SocketAddress::Wildcard(), flags, error);
+	if (sent < 0) {
+		if ((error != NET_ENOTCONN || !_peerAddress) && error != NET_EWOULDBLOCK)
+			SetException(error, ex, " (address=", _peerAddress, ", size=", size, ", flags=", flags, ", parts=", count, ")");
+		return -1; // is connecting or can't send more now (wait onFlush), or error
+	}
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+	send(sent);
+	written += sent;
+	// advance across packet boundaries
+	uint32_t rest(sent);
+	while (rest) {
+		Sending& sending(_sendings.front());
+		if (rest < sending.size()) {
+			sending += rest;
+			break;
+		}
+		rest -= sending.size();
+		_sendings.pop_front();
+	}
+	return uint32_t(sent) < size ? -1 : 1; // if partial, can't send more!
+}
+#endif
+
+#if defined(__linux__)
+int Socket::sendDatagrams() {
+	// Send queued datagrams in one sendmmsg call, returns bytes sent, 0 to continue with the standard sending, -1 if can't send more now
+	enum {
+		MESSAGES = 64,
+		SEGMENTS = 64, // UDP_MAX_SEGMENTS
+		GSO_MAX = 65507 // max UDP payload in IPv4
+	};
+#if defined(UDP_SEGMENT)
+	static std::atomic<bool> GSO(true); // disabled on first unsupported GSO sending
+	bool coalesce(GSO);
+#else
+	bool coalesce(false);
+#endif
+	if (_ex || _sendings.size() < 2)
+		return 0; // use standard sending
+	mmsghdr headers[MESSAGES];
+	iovec	iovecs[MESSAGES * 4];
+	union {
+		char		buffer[CMSG_SPACE(sizeof(uint16_t))];
+		cmsghdr		align;
+	}		controls[MESSAGES];
+	uint16_t counts[MESSAGES]; // sendings by message
+	uint32_t messages(0), iovs(0);
+	int flags(_sendings.front().flags);
+	bool gso(false);
+
+	auto it = _sendings.begin();
+	while (it != _sendings.end() && messages < MESSAGES && it->flags == flags && iovs < sizeof(iovecs) / sizeof(iovec)) {
+		mmsghdr& header(headers[messages]);
+		memset(&header, 0, sizeof(header));
+		if (it->address) {
+			header.msg_hdr.msg_name = (void*)it->address.data();
+			header.msg_hdr.msg_namelen = it->address.size();
+		}
+		header.msg_hdr.msg_iov = &iovecs[iovs];
+		uint32_t segment(it->size()), size(0);
+		uint16_t& count(counts[messages++] = 0);
+		do {
+			iovecs[iovs].iov_base = (void*)it->data();
+			iovecs[iovs++].iov_len = it->size();
+			size += it->size();
+			++count;
+			if (it++->size() < segment)
+				break; // last GSO segment can be smaller
+		} while (coalesce && it != _sendings.end() && it->flags == flags && it->size() <= segment && it->address == (it - 1)->address &&
+			count < SEGMENTS && (size + it->size()) <= GSO_MAX && iovs < sizeof(iovecs) / sizeof(iovec));
+		header.msg_hdr.msg_iovlen = count;
+#if defined(UDP_SEGMENT)
+		if (count > 1) {
+			gso = true;
+			header.msg_hdr.msg_control = controls[messages - 1].buffer;
+			header.msg_hdr.msg_controllen = sizeof(controls[messages - 1].buffer);
+			cmsghdr* pControl = CMSG_FIRSTHDR(&header.msg_hdr);
+			pControl->cmsg_level = SOL_UDP;
+			pControl->cmsg_type = UDP_SEGMENT;
+			pControl->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+			*(uint16_t*)CMSG_DATA(pControl) = uint16_t(segment);
+		}
+#endif
+	}
+	if (messages < 2 && !gso)
+		return 0; // useless, use standard sending
+
+#if defined(MSG_NOSIGNAL)
+	flags |= MSG_NOSIGNAL;
+#endif
+	int rc;
+	int error;
+	do {
+		rc = ::sendmmsg(_id, headers, messages, flags);
+	} while (rc < 0 && (error = Net::LastError()) == NET_EINTR);
+	if (rc < 0) {
+		if (error == NET_EWOULDBLOCK)
+			return -1; // can't send more now (wait onFlush)
+#if defined(UDP_SEGMENT)
+		if (gso && error == EIO)
+			GSO = false; // GSO unsupported by this system
+#endif
+		return 0; // use standard sending to assign the error to the right datagram (or to send without GSO)
+	}
+
+	if (!_address)
+		_address.set(IPAddress::Loopback(), 0); // to advise that address is computable
+	uint32_t sent(0);
+	for (int i = 0; i < rc; ++i) {
+		sent += headers[i].msg_len;
+		while (counts[i]--)
+			_sendings.pop_front();
+	}
+	send(sent);
+	return sent;
+}
+#endif
+
 
 
 } // namespace Mona
@@ -22,7 +22,9 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Memory/Packet.h"
 #include "Mona/Threading/Handler.h"
 #include "Mona/Util/Parameters.h"
+#include "Mona/Util/Metrics.h"
 #include <deque>
+#include <initializer_list>
 
 namespace Mona {
 
@@ -58,6 +60,16 @@ struct Socket : virtual Object, Net::Stats {
 		BACKLOG_MAX = 200 // blacklog maximum, see http://tangentsoft.net/wskfaq/advanced.html#backlog
 	};
 
+	/*!
+	Metrics aggregated over the sockets sharing it (sockets subscribed to a same IOSocket) */
+	struct Aggregate : virtual Object {
+		Metrics::Counter	recvBytes;
+		Metrics::Counter	recvCount; // receptions
+		Metrics::Counter	sendBytes;
+		Metrics::Counter	sendCount; // sendings
+		Metrics::Gauge		queueing; // bytes
+	};
+
 	/*!
 	Creates a Socket which supports IPv4 and IPv6 */
 	Socket(Type type);
@@ -69,6 +81,10 @@ struct Socket : virtual Object, Net::Stats {
 	operator NET_SOCKET() const { return _id; }
 
 	virtual bool		isSecure() const { return false; }
+	/*!
+	True if data are encrypted in user space before to reach the system socket, in which case gathering and zero-copy file sending are impossible
+	(false for a secure socket whose encryption is offloaded to the kernel) */
+	virtual bool		isEncrypting() const { return isSecure(); }
 
 	Time				recvTime() const { return _recvTime.load(); }
 	uint64_t				recvByteRate() const { return _recvByteRate; }
@@ -145,8 +161,29 @@ struct Socket : virtual Object, Net::Stats {
 	Returns size of data sent immediatly (or -1 if error, for TCP socket a SHUTDOWN_SEND is done, so socket will be disconnected) */
 	int			 write(Exception& ex, const Packet& packet, int flags = 0) { return write(ex, packet, SocketAddress::Wildcard(), flags); }
 	int			 write(Exception& ex, const Packet& packet, const SocketAddress& address, int flags = 0);
+	/*!
+	Multi-part writing without concatenation, parts are sent in one gathering system call (sendmsg),
+	for a datagram socket parts make one datagram */
+	int			 write(Exception& ex, std::initializer_list<Packet> packets, int flags = 0) { return write(ex, packets, SocketAddress::Wildcard(), flags); }
+	int			 write(Exception& ex, std::initializer_list<Packet> packets, const SocketAddress& address, int flags = 0);
 
 	bool		 flush(Exception& ex) { return flush(ex, false); }
+	/*!
+	Queue a datagram without sending it, to send it later by batch on flush(ex) call,
+	on Linux queued datagrams are sent with sendmmsg, and consecutive datagrams to a same address are coalesced with UDP GSO */
+	void		 queue(const Packet& packet, const SocketAddress& address, int flags = 0);
+#if defined(__linux__)
+	/*!
+	Zero-copy writing of a file region (sendfile), just for a plain stream socket, sequential with other writing,
+	rest is queued if can't be sent immediatly (flush required on onFlush event), pOwner has to keep alive the file descriptor.
+	Returns size of data sent immediatly (or -1 if error, a SHUTDOWN_SEND is done) */
+	int64_t		 write(Exception& ex, int fd, uint64_t offset, uint64_t size, const Shared<const Object>& pOwner, int flags = 0);
+#endif
+	/*!
+	Call onFlushed one time when queueing() becomes inferior or equal to threshold, in the flushing thread (immediatly in this thread if already),
+	or with the error if sending fails or if socket is deleted before,
+	allows an internal writer to wait the socket without onFlush subscription (see IOFile::send), just one waiter at a time */
+	void		 waitFlush(uint64_t threshold, std::function<void(const Exception&)>&& onFlushed);
 
 	template <typename ...Args>
 	static Exception& SetException(int error, Exception& ex, Args&&... args) {
@@ -167,8 +204,27 @@ protected:
 	virtual int		receive(Exception& ex, char* buffer, uint32_t size, int flags, SocketAddress* pAddress);
 
 
-	void			send(uint32_t count) { _sendTime = Time::Now(); _sendByteRate += count; }
-	void			receive(uint32_t count) { _recvTime = Time::Now(); _recvByteRate += count; }
+	void			send(uint32_t count) {
+		_sendTime = Time::Coarse();
+		_sendByteRate += count;
+		if (Aggregate* pAggregate = _aggregate.load(std::memory_order_relaxed)) {
+			pAggregate->sendBytes += count;
+			++pAggregate->sendCount;
+		}
+	}
+	void			receive(uint32_t count) {
+		_recvTime = Time::Coarse();
+		_recvByteRate += count;
+		if (Aggregate* pAggregate = _aggregate.load(std::memory_order_relaxed)) {
+			pAggregate->recvBytes += count;
+			++pAggregate->recvCount;
+		}
+	}
+	uint64_t		addQueueing(int64_t bytes) {
+		if (Aggregate* pAggregate = _aggregate.load(std::memory_order_relaxed))
+			pAggregate->queueing += bytes;
+		return _queueing += bytes;
+	}
 	virtual bool	flush(Exception& ex, bool deleting);
 	virtual bool	close(ShutdownType type = SHUTDOWN_BOTH) { return ::shutdown(_id, type) == 0; }
 
@@ -190,6 +246,18 @@ protected:
 	mutable std::atomic<int>	_sendBufferSize;
 
 private:
+#if defined(__linux__)
+	int			 sendDatagrams();
+#endif
+#if !defined(_WIN32)
+	int			 sendStream(Exception& ex, uint64_t& written);
+#endif
+#if defined(__linux__)
+	int64_t		 sendFile(Exception& ex, int fd, uint64_t offset, uint64_t size);
+#endif
+	/*!
+	Call the waitFlush waiter if queueing is under its threshold or on error */
+	void		 flushed(std::unique_lock<std::mutex>& lock, const Exception& ex = nullptr);
 	virtual bool setIPV6Only(Exception& ex, bool enable) { return setOption(ex, IPPROTO_IPV6, IPV6_V6ONLY, enable ? 1 : 0); }
 	virtual void computeAddress();
 
@@ -226,16 +294,26 @@ private:
 	}
 
 	struct Sending : Packet, virtual Object {
-		Sending(const Packet& packet, const SocketAddress& address, int flags) : Packet(std::move(packet)), address(address), flags(flags) {}
+		Sending(const Packet& packet, const SocketAddress& address, int flags) : Packet(std::move(packet)), address(address), flags(flags), fd(-1), offset(0) {}
+		Sending(int fd, uint64_t offset, uint64_t size, const Shared<const Object>& pOwner, int flags) : address(SocketAddress::Wildcard()), flags(flags), fd(fd), offset(offset), rest(size), pOwner(pOwner) {}
 
 		const SocketAddress address;
 		const int			flags;
+		// file region to send (fd>=0), pOwner keeps the file descriptor alive
+		const int					fd;
+		uint64_t					offset;
+		uint64_t					rest;
+		const Shared<const Object>	pOwner;
 	};
 
 	Exception					_ex;
 	mutable std::mutex			_mutexSending;
 	std::deque<Sending>			_sendings;
 	std::atomic<uint64_t>			_queueing;
+	std::function<void(const Exception&)> _onFlushed; // see waitFlush
+	uint64_t						_flushThreshold;
+	Shared<Aggregate>				_pAggregate; // owner, assigned on subscription
+	std::atomic<Aggregate*>			_aggregate; // for send/receive/queue without shared pointer copy
 
 	std::atomic<int64_t>			_recvTime;
 	ByteRate					_recvByteRate;
@@ -252,6 +330,8 @@ private:
 	OnDisconnection				_onDisconnection;
 
 	uint16_t						_threadReceive;
+	uint16_t						_threadSend; // track of Send actions, assigned by the reactor of the socket
+	std::atomic<uint16_t>			_reactor; // child reactor of IOSocket (sharding), read by unsubscribe from any thread
 	std::atomic<uint32_t>			_receiving;
 	std::atomic<uint8_t>			_reading;
 	std::atomic<bool>			_sending;
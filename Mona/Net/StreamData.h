@@ -17,7 +17,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #pragma once
 
 #include "Mona/Mona.h"
-#include "Mona/Memory/Packet.h"
+#include "Mona/Memory/Rope.h"
 
 namespace Mona {
 
@@ -27,41 +27,49 @@ struct StreamData : virtual Object {
 	bool addStreamData(const Packet& packet, uint32_t limit, Args... args) {
 		// Call onStreamData just one time to prefer recursivity rather "while repeat", and allow a "flush" info!
 		uint32_t rest;
-		Shared<Buffer> pBuffer(std::move(_pBuffer)); // because onStreamData returning 0 can delete this!
-		if (pBuffer) {
-			pBuffer->append(packet.data(), packet.size());
-			Packet buffer(static_pointer_cast<const Bytes>(pBuffer)); // trick to keep reference to _pBuffer!
-			rest = min(onStreamData(buffer, std::forward<Args>(args)...), pBuffer->size());
+		Unique<Rope> pRope(std::move(_pRope)); // because onStreamData returning 0 can delete this!
+		if (pRope) {
+			pRope->append(packet); // no copy, just referenced
+			rest = min(onStreamData(*pRope, std::forward<Args>(args)...), pRope->size());
 		} else {
-			Packet buffer(packet);
+			Packet buffer(packet); // nothing kept, contiguous data parsed without rope
 			rest = min(onStreamData(buffer, std::forward<Args>(args)...), packet.size());
 		}
 		if (!rest) // no rest, can have deleted this, so return immediatly!
 			return true;
-		if (rest > limit) // test limit on rest no before to allow a pBuffer in input of limit size + pBuffer stored = limit size too
+		if (rest > limit) // test limit on rest no before to allow a pRope in input of limit size + pRope stored = limit size too
 			return false;
-		_pBuffer = std::move(pBuffer);
-		if (!_pBuffer) { // copy!
-			_pBuffer.set(packet.data() + packet.size() - rest, rest);
-			return true;
-		}
-		if (!_pBuffer.unique()) { // if not unique => packet hold by user in "parse", buffer immutable now
-			_pBuffer.set(_pBuffer->data() + _pBuffer->size() - rest, rest);
-			return true;
-		}
-		if (rest < _pBuffer->size()) {
-			memmove(_pBuffer->data(), _pBuffer->data() + _pBuffer->size() - rest, rest);
-			_pBuffer->resize(rest, true);
-		}
+		if (pRope)
+			pRope->clip(pRope->size() - rest);
+		else
+			pRope.set().append(Packet(packet, packet.data() + packet.size() - rest, rest));
+		_pRope = std::move(pRope);
+		_pRope->bufferize(); // copy just unbuffered rest or small rest of a big buffer!
 		return true;
 	}
-	void clearStreamData() { _pBuffer.reset(); }
-	Shared<Buffer>& clearStreamData(Shared<Buffer>& pBuffer) { return pBuffer = std::move(_pBuffer); }
+	void clearStreamData() { _pRope.reset(); }
+	Shared<Buffer>& clearStreamData(Shared<Buffer>& pBuffer) {
+		if (!_pRope)
+			return pBuffer.reset();
+		_pRope->copy(0, pBuffer.set(_pRope->size()).data(), _pRope->size());
+		_pRope.reset();
+		return pBuffer;
+	}
 
 private:
+	/*!
+	Parse the chain of received packets (not copied) when a rest has been kept by the previous call, returns the rest to keep for the next call.
+	By default calls onStreamData(Packet&) with rope.front(), data are materialized just if they straddle several packets */
+	virtual uint32_t onStreamData(Rope& rope, Args... args) {
+		Packet buffer(rope.front());
+		return onStreamData(buffer, std::forward<Args>(args)...);
+	}
+	/*!
+	Parse contiguous data received, directly called when no rest is kept (no rope), returns the rest to keep for the next call.
+	Pure to not lost data of a parser which overrides just onStreamData(Rope&), it can forward buffer to it with a Rope referencing buffer */
 	virtual uint32_t onStreamData(Packet& buffer, Args... args) = 0;
 
-	Shared<Buffer> _pBuffer;
+	Unique<Rope> _pRope;
 };
 
 } // namespace Mona
@@ -56,9 +56,42 @@ bool TLS::Create(Exception& ex, const char* cert, const char* key, Shared<TLS>&
 	return false;
 }
 
-TLS::Socket::Socket(Type type, const Shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(type), _ssl(NULL) {}
+bool TLS::setKernelOffload(bool enable) {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+	if (enable)
+		SSL_CTX_set_options(_pCTX, SSL_OP_ENABLE_KTLS);
+	else
+		SSL_CTX_clear_options(_pCTX, SSL_OP_ENABLE_KTLS);
+	return true;
+#else
+	return !enable;
+#endif
+}
+
+bool TLS::kernelOffload() const {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+	return (SSL_CTX_get_options(_pCTX) & SSL_OP_ENABLE_KTLS) ? true : false;
+#else
+	return false;
+#endif
+}
 
-TLS::Socket::Socket(NET_SOCKET sockfd, const sockaddr& addr, const Shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(sockfd, addr), _ssl(NULL) {}
+TLS::Socket::Socket(Type type, const Shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(type), _ssl(NULL), _writePending(false), _offloadSend(false), _offloadRecv(false) {}
+
+TLS::Socket::Socket(NET_SOCKET sockfd, const sockaddr& addr, const Shared<TLS>& pTLS) : pTLS(pTLS), Mona::Socket(sockfd, addr), _ssl(NULL), _writePending(false), _offloadSend(false), _offloadRecv(false) {}
+
+void TLS::Socket::offload() {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+	if ((_offloadSend && _offloadRecv) || !(SSL_get_options(_ssl) & SSL_OP_ENABLE_KTLS) || !SSL_is_init_finished(_ssl))
+		return;
+	// OpenSSL has installed kernel keys if supported (else it stays in user space encryption)
+	// but switch just when no record is pending in OpenSSL buffers to keep stream order
+	if (!_offloadSend && !_writePending && BIO_get_ktls_send(SSL_get_wbio(_ssl)))
+		_offloadSend = true;
+	if (!_offloadRecv && !SSL_has_pending(_ssl) && BIO_get_ktls_recv(SSL_get_rbio(_ssl)))
+		_offloadRecv = true;
+#endif
+}
 
 TLS::Socket::~Socket() {
 	if (!_ssl)
@@ -74,8 +107,8 @@ TLS::Socket::~Socket() {
 
 uint32_t TLS::Socket::available() const {
 	uint32_t available = Mona::Socket::available();
-	if (!pTLS)
-		return available; // normal socket
+	if (!pTLS || _offloadRecv)
+		return available; // normal socket or kernel decryption
 	lock_guard<mutex> lock(_mutex);
 	if (!_ssl)
 		return available;
@@ -132,6 +165,14 @@ int TLS::Socket::receive(Exception& ex, char* buffer, uint32_t size, int flags,
 	if (!pTLS)
 		return Mona::Socket::receive(ex, buffer, size, flags, pAddress); // normal socket
 
+	if (_offloadRecv) {
+		// kernel decryption, EIO signals a TLS control record (alert, post-handshake message) which requires SSL_read
+		int result = Mona::Socket::receive(ex, buffer, size, flags, pAddress);
+		if (result >= 0 || ex.cast<Ex::Net::Socket>().code != EIO)
+			return result;
+		ex = nullptr;
+	}
+
 	unique_lock<mutex> lock(_mutex);
 	if (!_ssl)
 		return Mona::Socket::receive(ex, buffer, size, flags, pAddress); // normal socket
@@ -139,6 +180,7 @@ int TLS::Socket::receive(Exception& ex, char* buffer, uint32_t size, int flags,
 	if (!SSL_is_init_finished(_ssl)) {
 		if (catchResult(ex, SSL_do_handshake(_ssl)) < 0)
 			return -1;
+		offload();
 		lock.unlock(); // always unlock to flush because cann call TLS::sendTo which relock _mutex
 		// try to flush data queueing after handshake gotten!
 		Mona::Socket::flush(ex, false);
@@ -149,20 +191,26 @@ int TLS::Socket::receive(Exception& ex, char* buffer, uint32_t size, int flags,
 	// assign pAddress (no other way possible here)
 	if(pAddress)
 		pAddress->set(peerAddress());
-	if(result > 0)
+	if (result > 0) {
 		Mona::Socket::receive(result);
+		offload(); // offload possible now if data was pending in OpenSSL after handshake
+	}
 	return result;
 }
 
 int TLS::Socket::sendTo(Exception& ex, const char* data, uint32_t size, const SocketAddress& address, int flags) {
-	if (!pTLS)
-		return Mona::Socket::sendTo(ex, data, size, address, flags); // normal socket
+	if (!pTLS || _offloadSend)
+		return Mona::Socket::sendTo(ex, data, size, address, flags); // normal socket or kernel encryption
 	lock_guard<mutex> lock(_mutex);
 	if (!_ssl)
 		return Mona::Socket::sendTo(ex, data, size, address, flags); // normal socket
 	int result = catchResult(ex, SSL_write(_ssl, data, size), " (address=", address ? address : peerAddress(), ", size=", size, ")");
-	if (result > 0)
+	// a failed SSL_write has to be retried with same data (record can be pending in OpenSSL)
+	_writePending = result < 0;
+	if (result > 0) {
 		Mona::Socket::send(result);
+		offload();
+	}
 	return result;
 }
 
@@ -173,6 +221,8 @@ bool TLS::Socket::flush(Exception& ex, bool deleting) {
 	// maybe WRITE event for handshake need!
 	unique_lock<mutex> lock(_mutex);
 	if (!_ssl || catchResult(ex, SSL_do_handshake(_ssl)) > 0) {
+		if (_ssl)
+			offload();
 		lock.unlock(); // always unlock to flush because can call TLS::sendTo which relock _mutex
 		return Mona::Socket::flush(ex, deleting);
 	}
@@ -30,6 +30,13 @@ struct TLS : virtual Object {
 	static bool Create(Exception& ex, const std::string& cert, const std::string& key, Shared<TLS>& pTLS, const SSL_METHOD* method = SSLv23_method()) { return Create(ex, cert.c_str(), key.c_str(), pTLS, method); }
 	static bool Create(Exception& ex, const char* cert, const char* key, Shared<TLS>& pTLS, const SSL_METHOD* method = SSLv23_method());
 
+	/*!
+	Opt-in kernel TLS offload (kTLS): once handshake done, session keys are pushed to the system socket (setsockopt TCP_ULP "tls"),
+	then data are sent and received by plain Socket paths (gathering, sendfile) without SSL_write/SSL_read and mutex.
+	To call before sockets creation, returns false if OpenSSL has been built without kTLS support.
+	If the kernel doesn't support it the socket keeps user space encryption */
+	bool setKernelOffload(bool enable);
+	bool kernelOffload() const;
 
 	struct Socket : virtual Object, Mona::Socket {
 		// http://fm4dd.com/openssl/sslconnect.htm
@@ -42,6 +49,7 @@ struct TLS : virtual Object {
 		const Shared<TLS>	pTLS;
 
 		bool  isSecure() const override { return pTLS ? true : false; }
+		bool  isEncrypting() const override { return pTLS && !_offloadSend; }
 
 		uint32_t  available() const override;
 	
@@ -60,6 +68,10 @@ struct TLS : virtual Object {
 		// Create a socket from Socket::accept
 		Socket(NET_SOCKET sockfd, const sockaddr& addr, const Shared<TLS>& pTLS);
 
+		/*!
+		Switch to plain Socket paths for directions offloaded to the kernel, to call with _mutex locked */
+		void offload();
+
 		template <typename ...Args>
 		int catchResult(Exception& ex, int result, Args&&... args) {
 			switch (SSL_get_error(_ssl, result)) {
@@ -96,6 +108,9 @@ struct TLS : virtual Object {
 
 		ssl_st*				_ssl;
 		mutable std::mutex	_mutex;
+		bool				_writePending;
+		std::atomic<bool>	_offloadSend;
+		std::atomic<bool>	_offloadRecv;
 	};
 
 
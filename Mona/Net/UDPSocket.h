@@ -48,6 +48,12 @@ struct UDPSocket : virtual Object {
 
 	bool		send(Exception& ex, const Packet& packet, int flags = 0) { return send(ex, packet, SocketAddress::Wildcard(), flags); }
 	bool		send(Exception& ex, const Packet& packet, const SocketAddress& address, int flags = 0) { return socket()->write(ex, packet, address, flags) != -1; }
+	/*!
+	Batch sending, queue packets and send them in one time on flush call (sendmmsg and UDP GSO on Linux),
+	queueing() and onFlush are working as usual if all can't be sent immediatly */
+	void		queue(const Packet& packet, int flags = 0) { socket()->queue(packet, SocketAddress::Wildcard(), flags); }
+	void		queue(const Packet& packet, const SocketAddress& address, int flags = 0) { socket()->queue(packet, address, flags); }
+	bool		flush(Exception& ex) { return socket()->flush(ex); }
 
 	template<typename RunnerType>
 	void		send(const Shared<RunnerType>& pRunner) { io.threadPool.queue(_sendingTrack, pRunner); }
@@ -60,12 +66,26 @@ struct UDPSocket : virtual Object {
 			Runner("UDPSender"), _pSocket(pSocket), _flags(flags), _packet(std::move(packet)) { DEBUG_ASSERT(pSocket); }
 		Sender(const Shared<Socket>& pSocket, const Packet& packet, const SocketAddress& address, int flags = 0) :
 			Runner("UDPSender"), _pSocket(pSocket), _flags(flags), _packet(std::move(packet)), _address(address) { DEBUG_ASSERT(pSocket); }
+		/*!
+		Fan-out, send the same packet to several addresses by batch */
+		Sender(const Shared<Socket>& pSocket, const Packet& packet, std::vector<SocketAddress>&& addresses, int flags = 0) :
+			Runner("UDPSender"), _pSocket(pSocket), _flags(flags), _packet(std::move(packet)), _addresses(std::move(addresses)) { DEBUG_ASSERT(pSocket); }
 	private:
-		bool run(Exception& ex) { _pSocket->write(ex, _packet, _address, _flags);  return true; } // UDP socket error is a WARN
-		Shared<Socket>	_pSocket;
-		SocketAddress	_address;
-		Packet			_packet;
-		int				_flags;
+		bool run(Exception& ex) {
+			if (_addresses.empty()) {
+				_pSocket->write(ex, _packet, _address, _flags);
+				return true; // UDP socket error is a WARN
+			}
+			for (const SocketAddress& address : _addresses)
+				_pSocket->queue(_packet, address, _flags);
+			_pSocket->flush(ex);
+			return true; // UDP socket error is a WARN
+		}
+		Shared<Socket>				_pSocket;
+		SocketAddress				_address;
+		std::vector<SocketAddress>	_addresses;
+		Packet						_packet;
+		int							_flags;
 	};
 private:
 	virtual Socket::Decoder* newDecoder() { return NULL; }
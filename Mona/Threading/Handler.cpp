@@ -23,7 +23,6 @@ using namespace std;
 namespace Mona {
 
 void Handler::reset(Signal& signal) {
-	std::lock_guard<std::mutex> lock(_mutex);
 	_runners.clear();
 	_pSignal = &signal;
 }
@@ -31,18 +30,13 @@ void Handler::reset(Signal& signal) {
 uint32_t Handler::flush(bool last) {
 	// Flush all what is possible now, and not dynamically in real-time (in rechecking _runners)
 	// to keep the possibility to do something else between two flushs!
-	deque<Shared<Runner>> runners;
-	{
-		lock_guard<mutex> lock(_mutex);
-		if(last)
-			_pSignal = NULL;
-		runners = move(_runners);
+	if (last) {
+		_pSignal = NULL;
+		// wait producers which have read _pSignal before, to flush their runners and let them release the signal
+		while (_pushing)
+			this_thread::yield();
 	}
-	for (Shared<Runner>& pRunner : runners) {
-		pRunner->run('.', pRunner->name); // '.' to signal that its a sub-runner, wait the name of the thread in htop
-		pRunner.reset(); // release resources
-	}
-	return runners.size();
+	return _runners.flush('.'); // '.' to signal that its a sub-runner, wait the name of the thread in htop
 }
 
 bool Handler::tryQueue(const Event<void()>& onResult) const {
@@ -20,13 +20,12 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Threading/Runner.h"
 #include "Mona/Util/Event.h"
 #include "Mona/Threading/Signal.h"
-#include <deque>
 
 namespace Mona {
 
 struct Handler : virtual Object {
-	Handler(Signal& signal) : _pSignal(&signal) {}
-	Handler() : _pSignal(NULL) {}
+	Handler(Signal& signal) : _pSignal(&signal), _pushing(0) {}
+	Handler() : _pSignal(NULL), _pushing(0) {}
 
 	void	 reset(Signal& signal);
 	uint32_t	 flush(bool last=false);
@@ -36,17 +35,19 @@ struct Handler : virtual Object {
 	template<typename RunnerType, typename = typename std::enable_if<std::is_constructible<Shared<Runner>, RunnerType>::value>::type>
 	bool tryQueue(RunnerType&& pRunner) const {
 		DEBUG_ASSERT(pRunner); // more easy to debug that if it fails in the thread!
-		std::lock_guard<std::mutex> lock(_mutex);
-		if (!_pSignal)
-			return false;
-		_runners.emplace_back(std::forward<RunnerType>(pRunner));
-		_pSignal->set();
-		return true;
+		++_pushing; // before to read _pSignal, the last flush waits the end of this push (see flush)
+		Signal* pSignal = _pSignal.load();
+		if (pSignal) {
+			_runners.push(Shared<Runner>(std::forward<RunnerType>(pRunner)));
+			pSignal->set(); // system call just if the consumer thread is waiting
+		}
+		--_pushing;
+		return pSignal ? true : false;
 	}
 	/*!
 	Try to build and queue a RunnerType, returns false if failed */
 	template <typename RunnerType, typename ...Args>
-	bool tryQueue(Args&&... args) const { return tryQueue(std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
+	bool tryQueue(Args&&... args) const { return tryQueue(Runner::Make<RunnerType>(std::forward<Args>(args)...)); }
 	/*!
 	Try to queue an event with arguments call, returns false if failed */
 	template<typename ResultType, typename ...Args>
@@ -58,7 +59,7 @@ struct Handler : virtual Object {
 			Event<void(ResultType)>								_onResult;
 			typename std::remove_reference<ResultType>::type	_result;
 		};
-		return tryQueue(std::make_shared<Result>(onResult, std::forward<Args>(args)...));
+		return tryQueue(Runner::Make<Result>(onResult, std::forward<Args>(args)...));
 	}
 	/*!
 	Try to queue an event without argument, returns false if failed */
@@ -74,7 +75,7 @@ struct Handler : virtual Object {
 	Build and queue a RunnerType, returns false if failed */
 	template <typename RunnerType, typename ...Args>
 	void queue(Args&&... args) const {
-		if(!tryQueue(std::make_shared<RunnerType>(std::forward<Args>(args)...)))
+		if(!tryQueue(Runner::Make<RunnerType>(std::forward<Args>(args)...)))
 			FATAL_ERROR("Impossible to queue ", typeOf<RunnerType>());
 	}
 	/*!
@@ -93,9 +94,9 @@ struct Handler : virtual Object {
 
 private:
 
-	mutable std::mutex					_mutex;
-	mutable std::deque<Shared<Runner>>	_runners;
-	Signal*								_pSignal;
+	mutable Runner::Queue				_runners;
+	std::atomic<Signal*>				_pSignal;
+	mutable std::atomic<uint32_t>		_pushing; // producers between _pSignal read and push
 };
 
 
@@ -18,7 +18,9 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Threading/Thread.h"
+#include "Mona/Threading/Tracing.h"
 #include "Mona/Logs/Logs.h"
+#include <mutex>
 
 namespace Mona {
 
@@ -30,6 +32,15 @@ struct Runner : virtual Object {
 	bool noLog;
 	bool noDump;
 
+	/*!
+	Build a shared RunnerType from a freelist by type (thread cached) rather than a heap allocation for each runner.
+	It stands in for intrusive runners pooled by type: queues and user code share Runner by Shared<Runner>,
+	so the runner and its control block stay one allocation recycled by the pool of this type */
+	template<typename RunnerType, typename ...Args>
+	static std::shared_ptr<RunnerType> Make(Args&&... args) {
+		return std::allocate_shared<RunnerType>(Allocator<RunnerType>(), std::forward<Args>(args)...);
+	}
+
 	template <typename ...Args>
 	void run(Args&&... args) {
 		Thread::ChangeName newName(std::forward<Args>(args)...);
@@ -38,7 +49,203 @@ struct Runner : virtual Object {
 		AUTO_ERROR(run(ex), newName);
 	}
 
+	/*!
+	Lock-free multiple producers single consumer queue, the consumer takes in one time the runners queued (snapshot) */
+	struct Queue : virtual Object {
+		Queue() : _pLast(NULL), _pushed(0), _popped(0) {}
+		~Queue() { clear(); }
+
+		bool empty() const { return !_pLast.load(); }
+		/*!
+		Runners queued and not already run (approximative while pushing or flushing) */
+		uint32_t size() const {
+			uint64_t popped = _popped.load(std::memory_order_relaxed);
+			uint64_t pushed = _pushed.load(std::memory_order_relaxed);
+			return pushed > popped ? uint32_t(pushed - popped) : 0; // relaxed loads can see a popped runner before its push
+		}
+
+		void push(Shared<Runner>&& pRunner) {
+			Node* pNode = new (Allocator<Node>().allocate(1)) Node(std::move(pRunner));
+			if (Tracing::Enabled())
+				pNode->queued = Tracing::Now();
+			_pushed.fetch_add(1, std::memory_order_relaxed); // before to be visible, the consumer can run it immediately
+			pNode->pPrevious = _pLast.load(std::memory_order_relaxed);
+			while (!_pLast.compare_exchange_weak(pNode->pPrevious, pNode)); // sequentially consistent to allow consumer idle detection
+		}
+		/*!
+		Run the runners queued before this call, args are given before runner name to Runner::run, returns count */
+		template <typename ...Args>
+		uint32_t flush(const Args&... args) {
+			uint32_t count(0);
+			Node* pNode = pop();
+			while (pNode) {
+				if (pNode->queued || Tracing::Enabled()) {
+					int64_t start(Tracing::Now());
+					pNode->pRunner->run(args..., pNode->pRunner->name);
+					Tracing::Record(pNode->pRunner->name, pNode->queued, start, Tracing::Now());
+				} else
+					pNode->pRunner->run(args..., pNode->pRunner->name);
+				pNode = release(pNode);  // release resources
+				++count;
+				_popped.store(_popped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); // single consumer
+			}
+			return count;
+		}
+		void clear() {
+			Node* pNode = pop();
+			while (pNode) {
+				pNode = release(pNode);
+				_popped.store(_popped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			}
+		}
+	private:
+		struct Node {
+			Node(Shared<Runner>&& pRunner) : pRunner(std::move(pRunner)), queued(0), pPrevious(NULL) {}
+			Shared<Runner>	pRunner;
+			int64_t			queued; // Tracing::Now() when pushed if tracing enabled, 0 otherwise
+			Node*			pPrevious; // pNext once popped
+		};
+		/*!
+		Take all the queued nodes in one exchange (without ABA problem) and reverse them to get queuing order */
+		Node* pop() {
+			Node* pNode = _pLast.exchange(NULL, std::memory_order_acquire);
+			Node* pNext(NULL);
+			while (pNode) {
+				Node* pPrevious = pNode->pPrevious;
+				pNode->pPrevious = pNext;
+				pNext = pNode;
+				pNode = pPrevious;
+			}
+			return pNext;
+		}
+		static Node* release(Node* pNode) {
+			Node* pNext = pNode->pPrevious;
+			pNode->~Node();
+			Allocator<Node>().deallocate(pNode, 1);
+			return pNext;
+		}
+
+		std::atomic<Node*>		_pLast;
+		std::atomic<uint64_t>	_pushed;
+		std::atomic<uint64_t>	_popped;
+	};
+
 private:
+	/*!
+	Freelist of one type: each thread caches up to CACHE free blocks, and exchanges half of them with a global depot
+	when its cache is full or empty (runners are often built by a thread and released by an other) */
+	template<typename Type>
+	struct Pool {
+		static Type* Alloc() {
+			Cache* pCache(GetCache());
+			if (!pCache || (!pCache->pFree && !GetDepot().pop(*pCache)))
+				return (Type*)::operator new(sizeof(Block));
+			Block* pBlock(pCache->pFree);
+			pCache->pFree = pBlock->pNext;
+			--pCache->count;
+			return (Type*)pBlock;
+		}
+		static void Free(Type* pType) {
+			Cache* pCache(GetCache());
+			if (!pCache)
+				return ::operator delete(pType); // thread is ending
+			if (pCache->count >= CACHE)
+				GetDepot().push(*pCache);
+			Block* pBlock((Block*)pType);
+			pBlock->pNext = pCache->pFree;
+			pCache->pFree = pBlock;
+			++pCache->count;
+		}
+	private:
+		enum { CACHE = 64, DEPOT = 1024 };
+		union Block {
+			Block* pNext;
+			typename std::aligned_storage<sizeof(Type), alignof(Type)>::type data;
+		};
+		struct List {
+			List() : pFree(NULL), count(0) {}
+			/*!
+			Move up to count blocks to list */
+			void move(List& list, uint32_t count) {
+				while (pFree && count--) {
+					Block* pBlock(pFree);
+					pFree = pBlock->pNext;
+					--this->count;
+					pBlock->pNext = list.pFree;
+					list.pFree = pBlock;
+					++list.count;
+				}
+			}
+			void clear() {
+				while (pFree) {
+					Block* pBlock(pFree);
+					pFree = pBlock->pNext;
+					::operator delete(pBlock);
+				}
+				count = 0;
+			}
+			Block*		pFree;
+			uint32_t	count;
+		};
+		struct Depot : List {
+			bool pop(List& cache) {
+				std::lock_guard<std::mutex> lock(_mutex);
+				List::move(cache, CACHE / 2);
+				return cache.pFree ? true : false;
+			}
+			void push(List& cache, uint32_t count = CACHE / 2) {
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (List::count < DEPOT) {
+					cache.move(self, count);
+					return;
+				}
+				List rest;
+				cache.move(rest, count);
+				rest.clear(); // depot full, release to system
+			}
+		private:
+			std::mutex _mutex;
+		};
+		struct Cache : List {
+			~Cache() {
+				GetDepot().push(self, List::count);
+				Ended() = true;
+			}
+		};
+		// never deleted, runners can be released by static objects deleted after it
+		static Depot& GetDepot() { static Depot* PDepot(new Depot()); return *PDepot; }
+		static bool&  Ended() { static thread_local bool Ended(false); return Ended; } // POD, stays readable after thread cache destruction
+		static Cache* GetCache() {
+			if (Ended())
+				return NULL;
+			thread_local Cache Cache;
+			return &Cache;
+		}
+	};
+
+	template<typename Type>
+	struct Allocator {
+		typedef Type value_type;
+		Allocator() {}
+		template<typename OtherType>
+		Allocator(const Allocator<OtherType>&) {}
+		Type* allocate(std::size_t count) { return count == 1 ? Pool<Type>::Alloc() : (Type*)::operator new(count * sizeof(Type)); }
+		void deallocate(Type* pType, std::size_t count) {
+			if (count == 1)
+				Pool<Type>::Free(pType);
+			else
+				::operator delete(pType);
+		}
+		template<typename OtherType>
+		bool operator==(const Allocator<OtherType>&) const { return true; }
+		template<typename OtherType>
+		bool operator!=(const Allocator<OtherType>&) const { return false; }
+	};
+
+	Shared<Runner>	_pQueued; // self reference while queued in a ThreadPool deque (MODE_STEALING), its slot is then just the runner pointer
+
+	friend struct ThreadPool;
+
 	// If ex is raised, an error is displayed if the operation has returned false
 	// otherwise a warning is displayed
 	virtual bool run(Exception& ex) = 0;
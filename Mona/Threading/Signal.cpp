@@ -16,6 +16,12 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Threading/Signal.h"
 #include "Mona/Util/Exceptions.h"
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <limits.h>
+#endif
 
 
 namespace Mona {
@@ -23,40 +29,61 @@ namespace Mona {
 using namespace std;
 
 bool Signal::wait(uint32_t millisec) {
-	unique_lock<mutex> lock(_mutex);
+	auto timeout(chrono::steady_clock::now() + chrono::milliseconds(millisec));
+	for (;;) {
+		// fast path, signaled
+		if (_autoReset ? _set.exchange(false) : _set.load())
+			return true;
+		chrono::steady_clock::duration remaining(0);
+		if (millisec && (remaining = timeout - chrono::steady_clock::now()) <= chrono::steady_clock::duration::zero())
+			return false;
+		++_waiters; // before to check _set again while sleeping, see set()
+#if defined(__linux__)
+		// sleep just if _set is always false
+		if (millisec) {
+			timespec time;
+			auto seconds(chrono::duration_cast<chrono::seconds>(remaining));
+			time.tv_sec = seconds.count();
+			time.tv_nsec = long(chrono::duration_cast<chrono::nanoseconds>(remaining - seconds).count());
+			syscall(SYS_futex, &_set, FUTEX_WAIT_PRIVATE, 0, &time, NULL, 0);
+		} else
+			syscall(SYS_futex, &_set, FUTEX_WAIT_PRIVATE, 0, NULL, NULL, 0);
+#else
+		{
+			unique_lock<mutex> lock(_mutex);
 #if !defined(_DEBUG)
-	try {
+			try {
 #endif
-		if (millisec) {
-			auto timeout(chrono::system_clock::now() + chrono::milliseconds(millisec));
-			while (!_set && _condition.wait_until(lock, timeout) == cv_status::no_timeout);
-		} else while (!_set)
-			_condition.wait(lock);
-
+				if (!_set) {
+					if (millisec)
+						_condition.wait_for(lock, remaining);
+					else
+						_condition.wait(lock);
+				}
 #if !defined(_DEBUG)
-	} catch (exception& exc) {
-		FATAL_ERROR("Wait signal failed, ", exc.what());
-	} catch (...) {
-		FATAL_ERROR("Wait signal failed, unknown error");
-	}
+			} catch (exception& exc) {
+				FATAL_ERROR("Wait signal failed, ", exc.what());
+			} catch (...) {
+				FATAL_ERROR("Wait signal failed, unknown error");
+			}
+#endif
+		}
 #endif
-	if (!_set)
-		return false;
-	if (_autoReset)
-		_set = false;
-	return true;
+		--_waiters;
+	}
 }
 
 void Signal::set() {
+	if (_set.exchange(true))
+		return; // already set, waiters have already been waked up
+	if (!_waiters)
+		return; // nobody sleeping, no system call
+#if defined(__linux__)
+	syscall(SYS_futex, &_set, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
 	lock_guard<mutex> lock(_mutex);
-	_set = true;
 	_condition.notify_all();
-}
-
-
-void Signal::reset() {
-	lock_guard<mutex> lock(_mutex);
-	_set = false;
+#endif
 }
 
 
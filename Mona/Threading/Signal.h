@@ -18,25 +18,31 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include <condition_variable>
+#include <atomic>
 
 namespace Mona {
 
 
+/*!
+Event to wake up a waiting thread, set() is lock-free and signals the system (futex on Linux) just if a thread is waiting */
 struct Signal : virtual Object {
-	Signal(bool autoReset=true) : _autoReset(autoReset), _set(false) {}
+	Signal(bool autoReset=true) : _autoReset(autoReset), _set(false), _waiters(0) {}
 
 	void set();
 
 	// return true if the event has been set
 	bool wait(uint32_t millisec = 0);
 
-	void reset();
+	void reset() { _set = false; }
 	
 private:
 	bool					_autoReset;
-	bool					_set;
+	std::atomic<uint32_t>	_set; // futex word on Linux
+	std::atomic<uint32_t>	_waiters;
+#if !defined(__linux__)
 	std::condition_variable _condition;
 	std::mutex				_mutex;
+#endif
 };
 
 
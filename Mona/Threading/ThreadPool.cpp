@@ -21,10 +21,239 @@ using namespace std;
 
 namespace Mona {
 
+/*!
+Worker of MODE_STEALING, executes in priority its pinned runners (ThreadQueue), then its own deque,
+then the runners injected by threads out of pool, and finally steals the runners of other workers */
+struct ThreadPool::Worker : ThreadQueue, virtual Object {
+	Worker(const ThreadPool& pool, uint16_t index, Priority priority) : ThreadQueue(priority), pool(pool), index(index), sleeping(true), _top(0), _bottom(0) {
+		for (Slot& slot : _slots) {
+			slot.pRunner = NULL;
+			slot.queued = 0;
+		}
+	}
+	~Worker() {
+		stop(); // before members deletion
+		int64_t queued;
+		while (take(queued)); // release resources
+	}
+
+	const ThreadPool&	pool;
+	const uint16_t		index;
+	std::atomic<bool>	sleeping; // idle (or stopped)
+
+	static thread_local Worker* PCurrent;
+
+	void wake() {
+		lock_guard<mutex> lock(_mutex);
+		start(_priority);
+		wakeUp.set();
+	}
+	bool empty() const { return _bottom.load(memory_order_acquire) <= _top.load(memory_order_acquire); }
+	uint32_t size() const { return uint32_t(max<int64_t>(_bottom.load(memory_order_acquire) - _top.load(memory_order_acquire), 0)); }
+
+	/*!
+	Chase-Lev deque, push and take by the owner thread only, steal by any other thread.
+	Fixed size ring of runner pointers stamped with their queuing time (Tracing::Now() if tracing enabled, 0 otherwise),
+	the runner holds itself while queued (Runner::_pQueued) what requires an unique runner (not queued elsewhere).
+	Push moves pRunner and returns true, or returns false when full */
+	bool push(Shared<Runner>& pRunner, int64_t queued) {
+		DEBUG_ASSERT(pRunner.unique());
+		int64_t bottom = _bottom.load(memory_order_relaxed);
+		if (bottom - _top.load(memory_order_acquire) >= int64_t(SIZE))
+			return false;
+		Runner* pQueued = pRunner.get();
+		pQueued->_pQueued = move(pRunner);
+		Slot& slot(_slots[bottom & (SIZE - 1)]);
+		slot.pRunner.store(pQueued, memory_order_relaxed);
+		slot.queued.store(queued, memory_order_relaxed);
+		atomic_thread_fence(memory_order_release);
+		_bottom.store(bottom + 1, memory_order_relaxed);
+		return true;
+	}
+	Shared<Runner> take(int64_t& queued) {
+		int64_t bottom = _bottom.load(memory_order_relaxed) - 1;
+		_bottom.store(bottom, memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);
+		int64_t top = _top.load(memory_order_relaxed);
+		if (top > bottom) {
+			_bottom.store(bottom + 1, memory_order_relaxed);
+			return nullptr;
+		}
+		const Slot& slot(_slots[bottom & (SIZE - 1)]);
+		Runner* pRunner = slot.pRunner.load(memory_order_relaxed);
+		queued = slot.queued.load(memory_order_relaxed);
+		if (top == bottom) {
+			// last one, race with thieves
+			if (!_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+				pRunner = NULL;
+			_bottom.store(bottom + 1, memory_order_relaxed);
+		}
+		return pRunner ? move(pRunner->_pQueued) : nullptr;
+	}
+	Shared<Runner> steal(int64_t& queued) {
+		int64_t top = _top.load(memory_order_acquire);
+		atomic_thread_fence(memory_order_seq_cst);
+		if (top >= _bottom.load(memory_order_acquire))
+			return nullptr;
+		const Slot& slot(_slots[top & (SIZE - 1)]);
+		Runner* pRunner = slot.pRunner.load(memory_order_relaxed); // not dereferenced before to win it
+		queued = slot.queued.load(memory_order_relaxed);
+		if (!_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+			return nullptr;
+		return move(pRunner->_pQueued);
+	}
+
+private:
+	bool run(Exception& ex, const volatile bool& requestStop) {
+		_PCurrent = this;
+		PCurrent = this;
+		sleeping = false;
+		_idle = false;
+		for (;;) {
+			// pinned runners, its track ordering is kept
+			if (_runners.flush())
+				continue;
+			int64_t queued(0);
+			Shared<Runner> pRunner(take(queued));
+			if (pRunner || (pRunner = pool.next(self, queued))) {
+				if (queued || Tracing::Enabled()) {
+					int64_t start(Tracing::Now());
+					pRunner->run(pRunner->name);
+					Tracing::Record(pRunner->name, queued, start, Tracing::Now());
+				} else
+					pRunner->run(pRunner->name);
+				pRunner.reset(); // release resources
+				continue;
+			}
+			// idle, publish sleeping before to check again pending runners (see ThreadPool::queue)
+			sleeping = true;
+			if (pool.pending()) {
+				sleeping = false;
+				continue;
+			}
+			bool timeout = requestStop || !wakeUp.wait(120000); // 2 mn of timeout
+			if (timeout) {
+				// publish idle state before to check again pinned runners (see ThreadQueue::queue)
+				_idle = true;
+				lock_guard<mutex> lock(_mutex);
+				if (_runners.empty() && !pool.pending()) {
+					stop(); // to set _stop immediatly!
+					return true;
+				}
+				_idle = false;
+			}
+			sleeping = false;
+		}
+	}
+
+	enum { SIZE = 4096 };
+	struct Slot {
+		std::atomic<Runner*>	pRunner;
+		std::atomic<int64_t>	queued;
+	};
+	std::atomic<int64_t>				_top;
+	std::atomic<int64_t>				_bottom;
+	Slot								_slots[SIZE];
+};
+
+thread_local ThreadPool::Worker* ThreadPool::Worker::PCurrent(NULL);
+
+
 void ThreadPool::init(uint16_t threads, Thread::Priority priority) {
+	_injected = 0;
 	_threads.resize(_size = threads ? threads : Thread::ProcessorCount());
-	for (uint16_t i = 0; i < _size; ++i)
-		_threads[i].set(priority);
+	for (uint16_t i = 0; i < _size; ++i) {
+		if (_mode == MODE_STEALING)
+			_threads[i].set<Worker>(self, i, priority);
+		else
+			_threads[i].set(priority);
+	}
+}
+
+uint16_t ThreadPool::assign() const {
+	uint16_t current = _current++;
+	if (_mode == MODE_STEALING) {
+		// prefer an idle thread for a new track
+		for (uint16_t i = 0; i < _size; ++i) {
+			uint16_t thread = (current + i) % _size;
+			if (((Worker&)*_threads[thread]).sleeping)
+				return thread;
+		}
+	}
+	return current % _size;
+}
+
+void ThreadPool::queue(Shared<Runner>&& pRunner) const {
+	DEBUG_ASSERT(pRunner); // more easy to debug that if it fails in the thread!
+	Worker* pWorker = Worker::PCurrent;
+	int64_t queued(Tracing::Enabled() ? Tracing::Now() : 0);
+	// queued by a worker of this pool => lock-free, excepting if runner is shared (can be queued elsewhere meanwhile)
+	if (!pWorker || &pWorker->pool != this || !pRunner.unique() || !pWorker->push(pRunner, queued)) {
+		lock_guard<mutex> lock(_injectionMutex);
+		_injection.emplace_back(move(pRunner), queued);
+		++_injected;
+	}
+	// wake up an idle thread, fence to read sleeping after publishing runner (see Worker::run)
+	atomic_thread_fence(memory_order_seq_cst);
+	uint16_t current = _current++;
+	for (uint16_t i = 0; i < _size; ++i) {
+		Worker& worker((Worker&)*_threads[(current + i) % _size]);
+		bool sleeping(true);
+		if (&worker != pWorker && worker.sleeping.compare_exchange_strong(sleeping, false))
+			return worker.wake();
+	}
+}
+
+Shared<Runner> ThreadPool::next(Worker& worker, int64_t& queued) const {
+	if (_injected) {
+		// take one injected runner and move a batch in deque to be stealable by other workers
+		lock_guard<mutex> lock(_injectionMutex);
+		if (!_injection.empty()) {
+			Shared<Runner> pRunner(move(_injection.front().first));
+			queued = _injection.front().second;
+			_injection.pop_front();
+			for (uint16_t i = 0; i < 16 && !_injection.empty() && _injection.front().first.unique() && worker.push(_injection.front().first, _injection.front().second); ++i)
+				_injection.pop_front();
+			_injected = _injection.size();
+			return pRunner;
+		}
+	}
+	for (uint16_t i = 1; i < _size; ++i) {
+		Shared<Runner> pRunner(((Worker&)*_threads[(worker.index + i) % _size]).steal(queued));
+		if (pRunner)
+			return pRunner;
+	}
+	return nullptr;
+}
+
+bool ThreadPool::pending() const {
+	if (_injected)
+		return true;
+	for (const Unique<ThreadQueue>& pThread : _threads) {
+		if (!((Worker&)*pThread).empty())
+			return true;
+	}
+	return false;
+}
+
+uint32_t ThreadPool::queueing(uint16_t thread) const {
+	if (thread) {
+		const ThreadQueue& queue(*_threads[thread - 1]);
+		return queue.queueing() + (_mode == MODE_STEALING ? ((const Worker&)queue).size() : 0);
+	}
+	uint32_t count(_mode == MODE_STEALING ? _injected.load() : 0);
+	for (uint16_t i = 1; i <= _size; ++i)
+		count += queueing(i);
+	return count;
+}
+
+void ThreadPool::collect(Metrics::Writer& writer, const string& prefix) const {
+	writer.write(prefix + "_threads", Metrics::TYPE_GAUGE, _size, "Threads of the pool");
+	string name(prefix + "_queueing"), labels;
+	for (uint16_t i = 1; i <= _size; ++i)
+		writer.write(name, Metrics::TYPE_GAUGE, queueing(i), "Runners waiting execution", String::Assign(labels, "thread=\"", i, '"').c_str());
+	if (_mode == MODE_STEALING)
+		writer.write(prefix + "_injected", Metrics::TYPE_GAUGE, _injected.load(), "Runners queued out of the pool waiting a thread");
 }
 
 uint16_t ThreadPool::join() {
@@ -18,37 +18,77 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include "Mona/Threading/ThreadQueue.h"
+#include "Mona/Util/Metrics.h"
+#include <deque>
 #include <vector>
 
 namespace Mona {
 
 struct ThreadPool : virtual Object {
-	ThreadPool(uint16_t threads = 0) : _current(0) { init(threads); }
-	ThreadPool(Thread::Priority priority, uint16_t threads = 0) : _current(0) { init(threads, priority); }
+	/*!
+	MODE_STEALING is opt-in and concerns just the runners queued without thread (queue(nullptr, ...)),
+	IOSocket and IOFile queue their actions on a track (thread assignment) to keep the ordering of a socket or a file,
+	so they are never stolen */
+	enum Mode {
+		MODE_FIXED = 0, // runners queued without thread are distributed in round-robin
+		MODE_STEALING // runners queued without thread go to per-thread lock-free deques (Chase-Lev) where idle threads steal them
+	};
+	ThreadPool(uint16_t threads = 0) : _current(0), _mode(MODE_FIXED) { init(threads); }
+	ThreadPool(Thread::Priority priority, uint16_t threads = 0) : _current(0), _mode(MODE_FIXED) { init(threads, priority); }
+	/*!
+	In MODE_STEALING a runner queued with a thread assignment (track) stays on its thread to keep ordering,
+	but a new track prefers an idle thread */
+	ThreadPool(Mode mode, uint16_t threads = 0, Thread::Priority priority = Thread::PRIORITY_NORMAL) : _current(0), _mode(mode) { init(threads, priority); }
+	~ThreadPool() { join(); }
 
+	Mode		mode() const { return _mode; }
 	uint16_t	threads() const { return _size; }
 
 	uint16_t	join();
 
+	/*!
+	Runners queued and not already run, of one thread (thread>0) or of all the pool (thread=0) */
+	uint32_t	queueing(uint16_t thread = 0) const;
+	/*!
+	Write threads and queue depths metrics */
+	void		collect(Metrics::Writer& writer, const std::string& prefix = "mona_threadpool") const;
+
 	template<typename RunnerType>
 	void queue(uint16_t& thread, RunnerType&& pRunner) const {
 		if (thread)
 			return _threads[thread - 1]->queue(std::forward<RunnerType>(pRunner));
-		_threads[thread = (_current++%_size)]->queue(std::forward<RunnerType>(pRunner));
+		_threads[thread = assign()]->queue(std::forward<RunnerType>(pRunner));
 		++thread;
 	}
 	template<typename RunnerType>
-	void queue(std::nullptr_t, RunnerType&& pRunner) const { uint16_t thread(0); queue<RunnerType>(thread, std::forward<RunnerType>(pRunner)); }
+	void queue(std::nullptr_t, RunnerType&& pRunner) const {
+		if (_mode == MODE_STEALING)
+			return queue(Shared<Runner>(std::forward<RunnerType>(pRunner)));
+		uint16_t thread(0);
+		queue<RunnerType>(thread, std::forward<RunnerType>(pRunner));
+	}
 	template <typename RunnerType, typename ...Args>
-	void queue(uint16_t& thread, Args&&... args) const { queue(thread, std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
+	void queue(uint16_t& thread, Args&&... args) const { queue(thread, Runner::Make<RunnerType>(std::forward<Args>(args)...)); }
 	template <typename RunnerType, typename ...Args>
-	void queue(std::nullptr_t, Args&&... args) const { uint16_t thread(0); queue<RunnerType>(thread, std::forward<Args>(args)...); }
+	void queue(std::nullptr_t, Args&&... args) const { queue(nullptr, Runner::Make<RunnerType>(std::forward<Args>(args)...)); }
 private:
 	void init(uint16_t threads, Thread::Priority priority = Thread::PRIORITY_NORMAL);
 
+	struct Worker;
+	uint16_t	assign() const;
+	void		queue(Shared<Runner>&& pRunner) const;
+	Shared<Runner> next(Worker& worker, int64_t& queued) const;
+	bool		pending() const;
+
 	mutable std::vector<Unique<ThreadQueue>>	_threads;
 	mutable std::atomic<uint16_t>					_current;
 	uint16_t										_size;
+	const Mode										_mode;
+
+	// MODE_STEALING, runners queued by a thread out of pool
+	mutable std::deque<std::pair<Shared<Runner>, int64_t>>	_injection; // runners with their queuing time (see Worker::push)
+	mutable std::mutex								_injectionMutex;
+	mutable std::atomic<uint32_t>					_injected;
 };
 
 
@@ -27,25 +27,20 @@ thread_local ThreadQueue* ThreadQueue::_PCurrent(NULL);
 bool ThreadQueue::run(Exception&, const volatile bool& requestStop) {
 	_PCurrent = this;
 	
+	_idle = false;
 	for (;;) {
 		bool timeout = !wakeUp.wait(120000); // 2 mn of timeout
-		for(;;) {
-			deque<Shared<Runner>> runners;
-			{
-				lock_guard<mutex> lock(_mutex);
-				if (_runners.empty()) {
-					if (!timeout && !requestStop)
-						break; // wait more
-					stop(); // to set _stop immediatly!
-					return true;
-				}
-				runners = move(_runners);
-			}
-			for (Shared<Runner>& pRunner : runners) {
-				pRunner->run(pRunner->name);
-				pRunner.reset(); // release resources
-			}
+		while (_runners.flush()); // flush all what is possible
+		if (!timeout && !requestStop)
+			continue; // wait more
+		// publish idle state before to check again runners (see queue)
+		_idle = true;
+		lock_guard<mutex> lock(_mutex);
+		if (_runners.empty()) {
+			stop(); // to set _stop immediatly!
+			return true;
 		}
+		_idle = false;
 	}
 }
 
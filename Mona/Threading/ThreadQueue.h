@@ -19,34 +19,42 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Threading/Thread.h"
 #include "Mona/Threading/Runner.h"
-#include <deque>
 
 namespace Mona {
 
 struct ThreadQueue : Thread, virtual Object {
-	ThreadQueue(Priority priority = PRIORITY_NORMAL) : _priority(priority) {}
+	ThreadQueue(Priority priority = PRIORITY_NORMAL) : _priority(priority), _idle(false) {}
 	virtual ~ThreadQueue() { stop(); }
 
 	static ThreadQueue*	Current() { return _PCurrent; }
 
+	/*!
+	Runners queued and not already run */
+	uint32_t			queueing() const { return _runners.size(); }
+
 	template<typename RunnerType>
 	void queue(RunnerType&& pRunner) {
 		DEBUG_ASSERT(pRunner); // more easy to debug that if it fails in the thread!
-		std::lock_guard<std::mutex> lock(_mutex);
-		start(_priority);
-		_runners.emplace_back(std::forward<RunnerType>(pRunner));
+		_runners.push(Shared<Runner>(std::forward<RunnerType>(pRunner)));
+		if (_idle || !running()) {
+			// thread stopping or stopped, lock to synchronize with its stop (see run)
+			std::lock_guard<std::mutex> lock(_mutex);
+			start(_priority);
+		}
 		wakeUp.set();
 	}
 	template <typename RunnerType, typename ...Args>
-	void queue(Args&&... args) { queue(std::make_shared<RunnerType>(std::forward<Args>(args)...)); }
-
-private:
-	bool run(Exception& ex, const volatile bool& requestStop);
+	void queue(Args&&... args) { queue(Runner::Make<RunnerType>(std::forward<Args>(args)...)); }
 
-	std::deque<Shared<Runner>>			_runners;
-	std::mutex							_mutex;
+protected:
+	Runner::Queue						_runners;
+	std::mutex							_mutex; // synchronize start and idle stop
+	std::atomic<bool>					_idle;
 	static thread_local ThreadQueue*	_PCurrent;
 	Priority							_priority;
+
+private:
+	bool run(Exception& ex, const volatile bool& requestStop);
 };
 
 
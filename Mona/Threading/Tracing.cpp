@@ -0,0 +1,232 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Threading/Tracing.h"
+#include "Mona/Threading/Thread.h"
+#include <map>
+
+#define TRACING_NAMES	256 // runner names traced, must be a power of 2
+#define TRACING_EVENTS	65536 // events kept in ring buffer, must be a power of 2
+
+using namespace std;
+
+namespace Mona {
+
+atomic<bool> Tracing::_Enabled(false);
+
+static inline uint8_t LastBit(uint64_t value) { // value must be not null
+#if defined(_WIN32)
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return uint8_t(index);
+#else
+	return uint8_t(63 - __builtin_clzll(value));
+#endif
+}
+
+static uint16_t Index(uint64_t value) {
+	if (value < Tracing::Histogram::SUB)
+		return uint16_t(value);
+	uint8_t exponent(LastBit(value));
+	if (exponent > 35) // clamp to the last bucket
+		return Tracing::Histogram::BUCKETS - 1;
+	return uint16_t((exponent - Tracing::Histogram::SUB_BITS + 1) * Tracing::Histogram::SUB + ((value >> (exponent - Tracing::Histogram::SUB_BITS)) & (Tracing::Histogram::SUB - 1)));
+}
+static uint64_t HighestValue(uint16_t index) {
+	if (index < Tracing::Histogram::SUB)
+		return index;
+	uint8_t shift(index / Tracing::Histogram::SUB - 1);
+	return ((uint64_t(Tracing::Histogram::SUB + (index & (Tracing::Histogram::SUB - 1))) + 1) << shift) - 1;
+}
+
+void Tracing::Histogram::record(uint64_t value) {
+	_counts[Index(value)].fetch_add(1, memory_order_relaxed);
+	_count.fetch_add(1, memory_order_relaxed);
+	_sum.fetch_add(value, memory_order_relaxed);
+	uint64_t max(_max.load(memory_order_relaxed));
+	while (value > max && !_max.compare_exchange_weak(max, value, memory_order_relaxed));
+}
+
+void Tracing::Histogram::add(const Histogram& histogram) {
+	for (uint16_t i = 0; i < BUCKETS; ++i)
+		_counts[i].fetch_add(histogram._counts[i].load(memory_order_relaxed), memory_order_relaxed);
+	_count.fetch_add(histogram.count(), memory_order_relaxed);
+	_sum.fetch_add(histogram.sum(), memory_order_relaxed);
+	uint64_t max(_max.load(memory_order_relaxed));
+	while (histogram.max() > max && !_max.compare_exchange_weak(max, histogram.max(), memory_order_relaxed));
+}
+
+void Tracing::Histogram::reset() {
+	for (atomic<uint64_t>& count : _counts)
+		count.store(0, memory_order_relaxed);
+	_count = _sum = _max = 0;
+}
+
+uint64_t Tracing::Histogram::percentile(double percentile) const {
+	uint64_t count(this->count());
+	if (!count)
+		return 0;
+	uint64_t rank(std::max<uint64_t>(uint64_t(percentile * count + 0.5), 1));
+	for (uint16_t i = 0; i < BUCKETS; ++i) {
+		uint64_t bucket(_counts[i].load(memory_order_relaxed));
+		if (bucket >= rank)
+			return i < BUCKETS - 1 ? std::min(HighestValue(i), max()) : max(); // last bucket has the clamped values
+		rank -= bucket;
+	}
+	return max();
+}
+
+/// Histograms by runner name, open addressing on name pointer (lock-free, never removed) ///
+
+struct Durations : virtual Object {
+	Tracing::Histogram wait;
+	Tracing::Histogram run;
+};
+static struct Entry {
+	atomic<const char*>	name;
+	atomic<Durations*>	pDurations;
+} _Entries[TRACING_NAMES];
+
+static Durations* Find(const char* name) {
+	uint32_t hash(uint32_t((uintptr_t(name) * 0x9E3779B97F4A7C15ull) >> 32));
+	for (uint32_t i = 0; i < TRACING_NAMES; ++i) {
+		Entry& entry(_Entries[(hash + i) & (TRACING_NAMES - 1)]);
+		const char* key(entry.name.load(memory_order_acquire));
+		if (!key && entry.name.compare_exchange_strong(key, name)) {
+			Durations* pDurations(new Durations());
+			entry.pDurations.store(pDurations, memory_order_release);
+			return pDurations;
+		}
+		if (key == name)
+			return entry.pDurations.load(memory_order_acquire); // NULL if in creation, event ignored
+	}
+	return NULL; // full
+}
+
+/// Ring buffer of events, seqlock by slot to ignore events overwritten while dumping ///
+
+static struct Event {
+	atomic<uint64_t>	sequence; // 2*n+1 while writing, 2*n+2 once written
+	atomic<const char*>	name;
+	atomic<uint32_t>	thread;
+	atomic<int64_t>		start;
+	atomic<int64_t>		wait; // -1 if unknown
+	atomic<int64_t>		duration;
+} _Events[TRACING_EVENTS];
+static atomic<uint64_t> _Written(0);
+
+void Tracing::Record(const char* name, int64_t queued, int64_t start, int64_t end) {
+	int64_t wait(queued ? max<int64_t>(start - queued, 0) : -1);
+	Durations* pDurations(Find(name));
+	if (pDurations) {
+		if (wait >= 0)
+			pDurations->wait.record(wait);
+		pDurations->run.record(end - start);
+	}
+	static thread_local uint32_t Thread(0);
+	if (!Thread)
+		Thread = Thread::CurrentId();
+	uint64_t n(_Written.fetch_add(1, memory_order_relaxed));
+	Event& event(_Events[n & (TRACING_EVENTS - 1)]);
+	event.sequence.store(2 * n + 1, memory_order_relaxed);
+	atomic_thread_fence(memory_order_release);
+	event.name.store(name, memory_order_relaxed);
+	event.thread.store(Thread, memory_order_relaxed);
+	event.start.store(start, memory_order_relaxed);
+	event.wait.store(wait, memory_order_relaxed);
+	event.duration.store(end - start, memory_order_relaxed);
+	event.sequence.store(2 * n + 2, memory_order_release);
+}
+
+Buffer& Tracing::Dump(Buffer& buffer) {
+	String::Append(buffer, "{\"traceEvents\":[");
+	uint64_t end(_Written.load(memory_order_acquire));
+	bool first(true);
+	for (uint64_t n = end > TRACING_EVENTS ? end - TRACING_EVENTS : 0; n < end; ++n) {
+		Event& event(_Events[n & (TRACING_EVENTS - 1)]);
+		if (event.sequence.load(memory_order_acquire) != 2 * n + 2)
+			continue; // in writing or overwritten
+		const char* name(event.name.load(memory_order_relaxed));
+		uint32_t thread(event.thread.load(memory_order_relaxed));
+		int64_t start(event.start.load(memory_order_relaxed));
+		int64_t wait(event.wait.load(memory_order_relaxed));
+		int64_t duration(event.duration.load(memory_order_relaxed));
+		atomic_thread_fence(memory_order_acquire);
+		if (event.sequence.load(memory_order_relaxed) != 2 * n + 2)
+			continue; // overwritten while reading
+		String::Append(buffer, first ? "\n{\"name\":\"" : ",\n{\"name\":\"");
+		first = false;
+		for (const char* cur = name ? name : "?"; *cur; ++cur) {
+			if (*cur == '"' || *cur == '\\')
+				String::Append(buffer, '\\');
+			String::Append(buffer, *cur);
+		}
+		String::Append(buffer, "\",\"cat\":\"runner\",\"ph\":\"X\",\"pid\":0,\"tid\":", thread, ",\"ts\":", start, ",\"dur\":", duration);
+		if (wait >= 0)
+			String::Append(buffer, ",\"args\":{\"wait\":", wait, '}');
+		String::Append(buffer, '}');
+	}
+	return String::Append(buffer, "\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+void Tracing::Collect(Metrics::Writer& writer, const string& prefix) {
+	// merge by name string (same name can have different pointers)
+	map<string, Unique<Durations>> durations;
+	string runner;
+	for (Entry& entry : _Entries) {
+		const char* name(entry.name.load(memory_order_acquire));
+		Durations* pDurations(name ? entry.pDurations.load(memory_order_acquire) : NULL);
+		if (!pDurations)
+			continue;
+		runner.clear(); // label value escaped
+		for (const char* cur = name; *cur; ++cur) {
+			if (*cur == '"' || *cur == '\\')
+				runner += '\\';
+			runner += *cur;
+		}
+		Unique<Durations>& pMerged(durations[runner]);
+		if (!pMerged)
+			pMerged.set();
+		pMerged->wait.add(pDurations->wait);
+		pMerged->run.add(pDurations->run);
+	}
+	static const double Quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+	string labels;
+	for (uint8_t i = 0; i < 2; ++i) {
+		string name(prefix + (i ? "_run_microseconds" : "_wait_microseconds"));
+		for (const auto& it : durations) {
+			const Histogram& histogram(i ? it.second->run : it.second->wait);
+			for (double quantile : Quantiles)
+				writer.write(name, Metrics::TYPE_SUMMARY, histogram.percentile(quantile), i ? "Runner execution duration" : "Runner waiting in queue before execution", String::Assign(labels, "runner=\"", it.first, "\",quantile=\"", quantile, '"').c_str());
+			String::Append(writer.buffer, name, "_sum{runner=\"", it.first, "\"} ", histogram.sum(), '\n', name, "_count{runner=\"", it.first, "\"} ", histogram.count(), '\n');
+		}
+	}
+}
+
+void Tracing::Reset() {
+	for (Entry& entry : _Entries) {
+		Durations* pDurations(entry.pDurations.load(memory_order_acquire));
+		if (!pDurations)
+			continue;
+		pDurations->wait.reset();
+		pDurations->run.reset();
+	}
+	for (Event& event : _Events)
+		event.sequence.store(0, memory_order_relaxed);
+}
+
+
+} // namespace Mona
@@ -0,0 +1,82 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Util/Metrics.h"
+#include <chrono>
+
+namespace Mona {
+
+/*!
+Runner execution tracing, records by runner name the queue waiting (enqueue to start) and run durations
+in HDR-style histograms, and each execution in a ring buffer dumpable in Chrome trace format (chrome://tracing, Perfetto).
+Disabled by default, costs then one relaxed atomic load by runner */
+struct Tracing : virtual Object {
+	/*!
+	Histogram of microseconds values with a relative precision of 1/16 (log2 buckets splitted in 16 linear sub-buckets) */
+	struct Histogram : virtual Object {
+		enum {
+			SUB_BITS = 4,
+			SUB = 1 << SUB_BITS,
+			BUCKETS = (36 - SUB_BITS + 1) * SUB // until 2^36 us (19 hours)
+		};
+		Histogram() : _count(0), _sum(0), _max(0) { for (std::atomic<uint64_t>& count : _counts) count = 0; }
+
+		void	 record(uint64_t value);
+		void	 add(const Histogram& histogram);
+		void	 reset();
+
+		uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+		uint64_t sum() const { return _sum.load(std::memory_order_relaxed); }
+		uint64_t max() const { return _max.load(std::memory_order_relaxed); }
+		/*!
+		Value at percentile (0 to 1), highest equivalent value of its bucket */
+		uint64_t percentile(double percentile) const;
+	private:
+		std::atomic<uint64_t> _counts[BUCKETS];
+		std::atomic<uint64_t> _count;
+		std::atomic<uint64_t> _sum;
+		std::atomic<uint64_t> _max;
+	};
+
+	static bool		Enabled() { return _Enabled.load(std::memory_order_relaxed); }
+	static void		Enable(bool enable = true) { _Enabled = enable; }
+	/*!
+	Monotonic time in microseconds */
+	static int64_t	Now() { return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+	/*!
+	Record a runner execution, queued is 0 if unknown */
+	static void		Record(const char* name, int64_t queued, int64_t start, int64_t end);
+
+	/*!
+	Write the last executions (ring buffer) in Chrome trace format (JSON) */
+	static Buffer&	Dump(Buffer& buffer);
+	/*!
+	Write wait and run durations by runner as Prometheus summaries (quantiles 0.5, 0.9, 0.99, 0.999) */
+	static void		Collect(Metrics::Writer& writer, const std::string& prefix = "mona_runner");
+	/*!
+	Clear histograms and ring buffer */
+	static void		Reset();
+
+private:
+	static std::atomic<bool> _Enabled;
+};
+
+
+} // namespace Mona
@@ -0,0 +1,49 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Timing/CoarseClock.h"
+
+
+using namespace std;
+
+namespace Mona {
+
+atomic<int64_t>		Time::_Coarse(0);
+atomic<uint32_t>	CoarseClock::_Count(0);
+
+CoarseClock::CoarseClock(uint32_t period) : period(max<uint32_t>(period, 1u)) {
+	if (!_Count++)
+		Time::_Coarse = Time::Now();
+	start(Thread::PRIORITY_HIGHEST);
+}
+
+CoarseClock::~CoarseClock() {
+	stop();
+	if (!--_Count)
+		Time::_Coarse = 0; // back to Time::Now()
+}
+
+bool CoarseClock::run(Exception& ex, const volatile bool& requestStop) {
+	while (!requestStop) {
+		if (wakeUp.wait(period)) // wait()==true means requestStop=true because there is no other wakeUp.set elsewhere
+			return true;
+		Time::Tick();
+	}
+	return true;
+}
+
+
+} // namespace Mona
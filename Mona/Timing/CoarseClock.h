@@ -0,0 +1,42 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Timing/Time.h"
+#include "Mona/Threading/Thread.h"
+
+namespace Mona {
+
+/*!
+Publish Time::Coarse() while running, a thread refreshes it every "period" milliseconds
+and event loops refresh it on each wake up (Time::Tick).
+Can be instantiated multiple times, Time::Coarse() stays coarse until the last one is deleted */
+struct CoarseClock : private Thread, virtual Object {
+	CoarseClock(uint32_t period = 1);
+	~CoarseClock();
+
+	const uint32_t period;
+
+private:
+	bool run(Exception& ex, const volatile bool& requestStop);
+
+	static std::atomic<uint32_t> _Count;
+};
+
+
+} // namespace Mona
@@ -18,6 +18,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 
 #include "Mona/Mona.h"
 #include <chrono>
+#include <atomic>
 
 namespace Mona {
 
@@ -75,9 +76,26 @@ struct Time : virtual Object {
 #endif
 	}
 
+	/*!
+	Coarse time in milliseconds, one relaxed atomic load when a CoarseClock is running, otherwise equals to Now().
+	For hot paths tolerating the CoarseClock period as precision (receive/send time, byte rate...) */
+	static int64_t Coarse() { int64_t now(_Coarse.load(std::memory_order_relaxed)); return now ? now : Now(); }
+	/*!
+	Refresh Coarse() if a CoarseClock is running, to call by event loops after each wake up */
+	static void Tick() {
+		int64_t coarse(_Coarse.load(std::memory_order_relaxed));
+		if (!coarse)
+			return;
+		int64_t now(Now());
+		while (coarse && coarse < now && !_Coarse.compare_exchange_weak(coarse, now, std::memory_order_relaxed)); // never go back
+	}
+
 protected:
 	virtual int64_t time() const { return _time; }
 private:
+	static std::atomic<int64_t>	_Coarse; // 0 when no CoarseClock
+
+	friend struct CoarseClock;
 
 	int64_t		 _time; // time en milliseconds with as reference 1/1/1970
 
@@ -22,74 +22,162 @@ using namespace std;
 
 namespace Mona {
 
+static inline uint8_t FirstBit(uint64_t value) { // value must be not null
+#if defined(_WIN32)
+	unsigned long index;
+	_BitScanForward64(&index, value);
+	return uint8_t(index);
+#else
+	return uint8_t(__builtin_ctzll(value));
+#endif
+}
+static inline uint8_t LastBit(uint64_t value) { // value must be not null
+#if defined(_WIN32)
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return uint8_t(index);
+#else
+	return uint8_t(63 - __builtin_clzll(value));
+#endif
+}
+static inline uint64_t Rotate(uint64_t value, uint8_t shift) { return shift ? ((value >> shift) | (value << (64 - shift))) : value; }
+
+
+Timer::Timer() : _count(0), _current(Time::Now()) {
+	memset(_bitmaps, 0, sizeof(_bitmaps));
+}
+
 Timer::~Timer() {
-	for(const auto& it : _timers) {
-		for (const OnTimer* pTimer : *it.second)
+	for (const Slot& slot : _slots) {
+		for (const OnTimer* pTimer = slot.pFirst; pTimer; pTimer = pTimer->_pNext)
 			pTimer->_nextRaising = 0;
 	}
 }
 
 const Timer::OnTimer& Timer::set(const OnTimer& onTimer,  uint32_t timeout) const {
-	Shared<std::set<const OnTimer*>> pMove;
-	if (!remove(onTimer, pMove)) {
+	if (!onTimer._nextRaising) {
 		add(onTimer, timeout);
 		return onTimer;
 	}
-	if (timeout) {
-		// MOVE (more efficient!)
-		++_count;
-		const auto& it = _timers.emplace(onTimer._nextRaising = Time::Now() + timeout, move(pMove));
-		if (!it.second)
-			it.first->second->emplace(&onTimer);
-		 else if (!it.first->second)
-			 it.first->second.set().emplace(&onTimer);
+	if (onTimer._pTimer != this)
+		FATAL_ERROR("Timer already used on an other Timer machine, create both individual Timer::Type rather");
+	if (!timeout) {
+		remove(onTimer);
+		onTimer._nextRaising = 0;
+		--_count;
+		return onTimer;
 	}
+	int64_t nextRaising(Time::Now() + timeout);
+	if (nextRaising < onTimer._nextRaising) {
+		// advance, move it now
+		remove(onTimer);
+		onTimer._nextRaising = nextRaising;
+		insert(onTimer);
+	} else // delay, lazy move on its previous raising time (see raise)
+		onTimer._nextRaising = nextRaising;
 	return onTimer;
 }
 
 void Timer::add(const OnTimer& onTimer,  uint32_t timeout) const {
 	if (!timeout)
 		return;
-	++_count;
-	auto& it(_timers[(onTimer._nextRaising=Time::Now() + timeout)]);
-	if (!it)
-		it.set();
-	it->emplace(&onTimer);
+	if (!_count++)
+		_current = Time::Now(); // empty wheel, can be aligned on now
+	onTimer._nextRaising = Time::Now() + timeout;
+	onTimer._pTimer = this;
+	insert(onTimer);
 }
 
-bool Timer::remove(const OnTimer& onTimer, Shared<std::set<const OnTimer*>>& pMove) const {
-	if (!onTimer._nextRaising)
-		return false;
-	const auto& it(_timers.find(onTimer._nextRaising));
-	if (it != _timers.end()) {
-		onTimer._nextRaising = 0;
-		--_count;
-		if (it->second->size() == 1) {
-			if(*it->second->begin() == &onTimer) {
-				pMove = move(it->second);
-				_timers.erase(it);
-				return true;
-			}
-		} else if(it->second->erase(&onTimer))
-			return true;
+void Timer::insert(const OnTimer& onTimer) const {
+	// level where the timer is reached before the full turn of its wheel
+	int64_t time(max<int64_t>(onTimer._nextRaising, _current));
+	uint64_t delta(time - _current);
+	uint8_t level(delta < SLOTS ? 0 : min<uint8_t>(LastBit(delta) / 6, LEVELS - 1));
+	uint8_t index((time >> (6 * level)) & (SLOTS - 1));
+	Slot& slot(_slots[onTimer._slot = level * SLOTS + index]);
+	onTimer._pNext = NULL;
+	if ((onTimer._pPrevious = slot.pLast))
+		slot.pLast->_pNext = &onTimer;
+	else {
+		slot.pFirst = &onTimer;
+		_bitmaps[level] |= 1ull << index;
+	}
+	slot.pLast = &onTimer;
+}
+
+void Timer::remove(const OnTimer& onTimer) const {
+	Slot& slot(_slots[onTimer._slot]);
+	if (onTimer._pPrevious)
+		onTimer._pPrevious->_pNext = onTimer._pNext;
+	else
+		slot.pFirst = onTimer._pNext;
+	if (onTimer._pNext)
+		onTimer._pNext->_pPrevious = onTimer._pPrevious;
+	else
+		slot.pLast = onTimer._pPrevious;
+	if (!slot.pFirst && onTimer._slot < PENDING)
+		_bitmaps[onTimer._slot / SLOTS] &= ~(1ull << (onTimer._slot & (SLOTS - 1)));
+}
+
+int64_t Timer::next() const {
+	// first level: slots from _current, exact raising time
+	int64_t next(numeric_limits<int64_t>::max());
+	if (_bitmaps[0])
+		next = _current + FirstBit(Rotate(_bitmaps[0], _current & (SLOTS - 1)));
+	// upper levels: time where the slot has to be cascaded, the slot of _current is for the next turn if _current is not its beginning
+	for (uint8_t level = 1; level < LEVELS; ++level) {
+		if (!_bitmaps[level])
+			continue;
+		uint8_t shift(6 * level);
+		int64_t slots(_current >> shift);
+		uint64_t bitmap(Rotate(_bitmaps[level], slots & (SLOTS - 1)));
+		if ((bitmap & 1) && !(_current & ((1ll << shift) - 1)))
+			return _current;
+		bitmap &= ~1ull;
+		next = min(next, (slots + (bitmap ? FirstBit(bitmap) : SLOTS)) << shift);
 	}
-	FATAL_ERROR("Timer already used on an other Timer machine, create both individual Timer::Type rather");
-	return false;
+	return next;
 }
 
 uint32_t Timer::raise() {
-	while (!_timers.empty()) {
-		const auto& it(_timers.begin());
-		int64_t waiting(it->first-Time::Now());
-		if (waiting>0)
-			return uint32_t(waiting); // > 0!
-		auto itTimers(move(it->second));
-		_timers.erase(it);
-		for (const OnTimer* pTimer : *itTimers) {
+	int64_t now(Time::Now());
+	while (_count) {
+		int64_t tick(next());
+		if (tick > now)
+			return uint32_t(tick - now); // > 0!
+		_current = tick;
+		// cascade upper levels which start on this tick
+		for (uint8_t level = 1; level < LEVELS && !(tick & ((1ll << (6 * level)) - 1)); ++level) {
+			Slot& slot(_slots[level * SLOTS + ((tick >> (6 * level)) & (SLOTS - 1))]);
+			const OnTimer* pTimer(slot.pFirst);
+			slot.pFirst = slot.pLast = NULL;
+			_bitmaps[level] &= ~(1ull << ((tick >> (6 * level)) & (SLOTS - 1)));
+			while (pTimer) {
+				const OnTimer* pNext(pTimer->_pNext);
+				insert(*pTimer);
+				pTimer = pNext;
+			}
+		}
+		// move timers of this tick in PENDING slot to allow set calls on them while raising
+		Slot& slot(_slots[tick & (SLOTS - 1)]);
+		Slot& pending(_slots[PENDING]);
+		pending = slot;
+		slot.pFirst = slot.pLast = NULL;
+		_bitmaps[0] &= ~(1ull << (tick & (SLOTS - 1)));
+		for (const OnTimer* pTimer = pending.pFirst; pTimer; pTimer = pTimer->_pNext)
+			pTimer->_slot = PENDING;
+		_current = tick + 1;
+		while (const OnTimer* pTimer = pending.pFirst) {
+			remove(*pTimer);
+			if (pTimer->_nextRaising > tick) {
+				insert(*pTimer); // delayed
+				continue;
+			}
+			uint32_t delay(uint32_t(now - pTimer->_nextRaising));
 			pTimer->_nextRaising = 0;
-			uint32_t timeout = (*pTimer)(uint32_t(-waiting));
 			--_count;
-			if(timeout)
+			uint32_t timeout = (*pTimer)(delay);
+			if (timeout)
 				add(*pTimer, timeout);
 		}
 	}
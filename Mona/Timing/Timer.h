@@ -19,14 +19,15 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Mona.h"
 #include "Mona/Timing/Time.h"
 #include "Mona/Util/Exceptions.h"
-#include <set>
-#include <map>
 
 namespace Mona {
 
 
+/*!
+Hierarchical timing wheel with a millisecond resolution: LEVELS wheels of 64 slots where each level
+covers 64 times the previous one, to get a O(1) set/cancel and a amortized O(1) raising */
 struct Timer : virtual Object {
-	Timer() : _count(0) {}
+	Timer();
 	~Timer();
 
 /*!
@@ -35,10 +36,10 @@ struct Timer : virtual Object {
 	struct OnTimer : std::function<uint32_t(uint32_t delay)>, virtual Object {
 		NULLABLE(!_nextRaising)
 
-		OnTimer() : _nextRaising(0), count(0) {}
+		OnTimer() : _nextRaising(0), count(0), _pPrevious(NULL), _pNext(NULL), _pTimer(NULL), _slot(0) {}
 		// explicit to forbid to pass in "const OnTimer" parameter directly a lambda function
 		template<typename FunctionType>
-		explicit OnTimer(FunctionType&& function) : _nextRaising(0), count(0), std::function<uint32_t(uint32_t)>(std::move(function)) {}
+		explicit OnTimer(FunctionType&& function) : _nextRaising(0), count(0), _pPrevious(NULL), _pNext(NULL), _pTimer(NULL), _slot(0), std::function<uint32_t(uint32_t)>(std::move(function)) {}
 
 		~OnTimer() { if (_nextRaising) FATAL_ERROR("OnTimer function deleting while running"); }
 
@@ -56,7 +57,12 @@ struct Timer : virtual Object {
 
 		const uint32_t count;
 	private:
-		mutable Time	_nextRaising;
+		mutable Time			_nextRaising;
+		// intrusive links in the slot of the timing wheel
+		mutable const OnTimer*	_pPrevious;
+		mutable const OnTimer*	_pNext;
+		mutable const Timer*	_pTimer;
+		mutable uint16_t		_slot;
 
 		friend struct Timer;
 	};
@@ -65,7 +71,8 @@ struct Timer : virtual Object {
 
 /*!
 	Set timer, timeout is the first raising timeout
-	If timeout is 0 it removes the timer! */
+	If timeout is 0 it removes the timer!
+	Delaying a timer already set just updates its nextRaising, it will be moved on its previous raising time (cheap to re-arm on every packet) */
 	const Timer::OnTimer& set(const Timer::OnTimer& onTimer, uint32_t timeout) const;
 
 /*!
@@ -73,11 +80,26 @@ struct Timer : virtual Object {
 	uint32_t raise();
 
 private:
-	void add(const OnTimer& onTimer,  uint32_t timeout) const;
-	bool remove(const OnTimer& onTimer, Shared<std::set<const OnTimer*>>& pMove) const;
+	enum {
+		LEVELS = 6, // 64^6 ms > 2 years
+		SLOTS = 64,
+		PENDING = LEVELS*SLOTS // slot of timers in raising
+	};
+	struct Slot {
+		Slot() : pFirst(NULL), pLast(NULL) {}
+		const OnTimer* pFirst;
+		const OnTimer* pLast;
+	};
+
+	void	add(const OnTimer& onTimer, uint32_t timeout) const;
+	void	insert(const OnTimer& onTimer) const;
+	void	remove(const OnTimer& onTimer) const;
+	int64_t	next() const;
 
-	mutable	uint32_t												_count;
-	mutable std::map<int64_t, Shared<std::set<const OnTimer*>>>	_timers;
+	mutable	uint32_t	_count;
+	mutable int64_t		_current; // next tick to raise
+	mutable Slot		_slots[PENDING + 1];
+	mutable uint64_t	_bitmaps[LEVELS]; // not empty slots
 };
 
 
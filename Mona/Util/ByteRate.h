@@ -23,9 +23,9 @@ details (or else see http://mozilla.org/MPL/2.0/).
 namespace Mona {
 
 /*!
-Thread Safe class to compute ByteRate */
+Thread Safe class to compute ByteRate, uses Time::Coarse() (precise enough for a rate computed at least every second) */
 struct ByteRate : virtual Object {
-	ByteRate(uint8_t delta=1) : _delta(delta*1000), _bytes(0), _rate(0), _time(Time::Now()) {}
+	ByteRate(uint8_t delta=1) : _delta(delta*1000), _bytes(0), _rate(0), _time(Time::Coarse()) {}
 
 	/*!
 	Add bytes to next byte rate calculation */
@@ -41,11 +41,11 @@ struct ByteRate : virtual Object {
 
 private:
 	void compute() const {
-		int64_t elapsed(Time::Now());
-		elapsed = elapsed - _time.exchange(elapsed);
-		if (elapsed <= _delta) // wait "_delta" before next compute rate
-			_time -= elapsed;
-		else
+		// exchanges just once by "_delta" period, otherwise reading is only loads
+		int64_t now(Time::Coarse());
+		int64_t time(_time.load(std::memory_order_relaxed));
+		int64_t elapsed(now - time);
+		if (elapsed > _delta && _time.compare_exchange_strong(time, now))
 			_rate = _bytes.exchange(0) * 1000.0 / elapsed;
 	}
 
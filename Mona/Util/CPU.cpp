@@ -0,0 +1,90 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Util/CPU.h"
+#if defined(_X86)
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#elif defined(_ARM64) && defined(__linux__)
+	#include <sys/auxv.h>
+	#include <asm/hwcap.h>
+#endif
+
+using namespace std;
+
+namespace Mona {
+
+#if defined(_X86)
+static void CPUID(uint32_t leaf, uint32_t registers[4]) {
+#if defined(_MSC_VER)
+	__cpuidex((int*)registers, leaf, 0);
+#else
+	__cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+static uint64_t XGETBV() {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32_t low, high;
+	__asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	return (uint64_t(high) << 32) | low;
+#endif
+}
+#endif
+
+static uint32_t DetectFeatures() {
+	uint32_t features = 0;
+#if defined(_X86)
+	uint32_t registers[4]; // eax, ebx, ecx, edx
+	CPUID(0, registers);
+	uint32_t leafs = registers[0];
+	if (!leafs)
+		return 0;
+	CPUID(1, registers);
+	if (registers[2] & (1 << 9))
+		features |= CPU::FEATURE_SSSE3;
+	if (registers[2] & (1 << 19))
+		features |= CPU::FEATURE_SSE41;
+	if (registers[2] & (1 << 1))
+		features |= CPU::FEATURE_PCLMUL;
+	// AVX2 requires too that OS saves YMM registers on context switch (OSXSAVE + XCR0)
+	if (leafs >= 7 && (registers[2] & (1 << 27)) && (XGETBV() & 6) == 6) {
+		CPUID(7, registers);
+		if (registers[1] & (1 << 5))
+			features |= CPU::FEATURE_AVX2;
+	}
+#elif defined(_ARM64)
+	features |= CPU::FEATURE_NEON; // mandatory on ARMv8
+#if defined(__linux__) && defined(HWCAP_PMULL)
+	if (getauxval(AT_HWCAP) & HWCAP_PMULL)
+		features |= CPU::FEATURE_PMULL;
+#elif defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES)
+	features |= CPU::FEATURE_PMULL;
+#endif
+#endif
+	return features;
+}
+
+uint32_t CPU::Features() {
+	static const uint32_t Features(DetectFeatures());
+	return Features;
+}
+
+} // namespace Mona
@@ -0,0 +1,56 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define _X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+	#define _ARM64 1
+#endif
+
+/*!
+Compiles a function for the given instruction sets (GCC/Clang syntax, "pclmul,ssse3" for example)
+without requiring global compilation flags, call it only if CPU::Has confirms the support at runtime.
+MSVC doesn't need it, its intrinsics are always available */
+#if defined(_MSC_VER) && !defined(__clang__)
+	#define TARGET(FEATURES)
+#else
+	#define TARGET(FEATURES) __attribute__((target(FEATURES)))
+#endif
+
+namespace Mona {
+
+/*!
+Instruction sets supported by the running processor, to dispatch vectorized code at runtime */
+struct CPU : virtual Static {
+	enum Feature : uint32_t {
+		FEATURE_SSSE3 = 1,
+		FEATURE_SSE41 = 2,
+		FEATURE_PCLMUL = 4,
+		FEATURE_AVX2 = 8,
+		FEATURE_NEON = 16,
+		FEATURE_PMULL = 32
+	};
+	/*!
+	Returns true if all the features given are supported */
+	static bool		Has(uint32_t features) { return (Features() & features) == features; }
+	static uint32_t Features();
+};
+
+} // namespace Mona
@@ -0,0 +1,125 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#include "Mona/Util/Metrics.h"
+#include "Mona/Util/Exceptions.h"
+
+
+using namespace std;
+
+namespace Mona {
+
+atomic<uint32_t> Metrics::_Threads(0);
+
+static uint64_t ToBits(double value) { uint64_t bits; memcpy(&bits, &value, sizeof(bits)); return bits; }
+static double FromBits(uint64_t bits) { double value; memcpy(&value, &bits, sizeof(value)); return value; }
+
+uint64_t Metrics::Counter::operator()() const {
+	uint64_t value(0);
+	for (const Shard& shard : _shards)
+		value += shard.value.load(memory_order_relaxed);
+	return value;
+}
+
+Metrics::Histogram::Histogram(const vector<double>& bounds) : _bounds(bounds),
+	_stride(((uint32_t(bounds.size()) + 2 + 7) / 8) * 8), _values(SHARDS * _stride) {
+	if (bounds.size() > MAX_BOUNDS)
+		FATAL_ERROR("Histogram with ", bounds.size(), " bounds, ", uint32_t(MAX_BOUNDS), " maximum");
+	for (atomic<uint64_t>& value : _values)
+		value = 0;
+}
+
+void Metrics::Histogram::observe(double value) {
+	atomic<uint64_t>* values(&_values[Metrics::Shard() * _stride]);
+	// non cumulative count by bucket, cumulated on reading
+	values[lower_bound(_bounds.begin(), _bounds.end(), value) - _bounds.begin()].fetch_add(1, memory_order_relaxed);
+	// sum, CAS just contended with threads of same shard
+	atomic<uint64_t>& sum(values[_bounds.size() + 1]);
+	uint64_t bits(sum.load(memory_order_relaxed));
+	while (!sum.compare_exchange_weak(bits, ToBits(FromBits(bits) + value), memory_order_relaxed));
+}
+
+uint64_t Metrics::Histogram::count(uint8_t bucket) const {
+	uint64_t count(0);
+	for (uint32_t shard = 0; shard < _values.size(); shard += _stride) {
+		for (uint8_t i = 0; i <= bucket; ++i)
+			count += _values[shard + i].load(memory_order_relaxed);
+	}
+	return count;
+}
+
+double Metrics::Histogram::sum() const {
+	double sum(0);
+	for (uint32_t shard = 0; shard < _values.size(); shard += _stride)
+		sum += FromBits(_values[shard + _bounds.size() + 1].load(memory_order_relaxed));
+	return sum;
+}
+
+void Metrics::Writer::family(const string& name, Type type, const char* help) {
+	if (name == _family)
+		return;
+	_family = name;
+	if (help)
+		String::Append(buffer, "# HELP ", name, ' ', help, '\n');
+	static const char* Types[] = { "counter", "gauge", "histogram", "summary" };
+	String::Append(buffer, "# TYPE ", name, ' ', Types[type], '\n');
+}
+
+Metrics::Writer& Metrics::Writer::write(const string& name, const Histogram& histogram, const char* help, const char* labels) {
+	family(name, TYPE_HISTOGRAM, help);
+	const char* separator(labels ? "," : "");
+	if (!labels)
+		labels = "";
+	for (uint8_t i = 0; i < histogram.bounds().size(); ++i)
+		String::Append(buffer, name, "_bucket{", labels, separator, "le=\"", histogram.bounds()[i], "\"} ", histogram.count(i), '\n');
+	uint64_t count(histogram.count());
+	String::Append(buffer, name, "_bucket{", labels, separator, "le=\"+Inf\"} ", count, '\n');
+	if (*labels)
+		String::Append(buffer, name, "_sum{", labels, "} ", histogram.sum(), '\n', name, "_count{", labels, "} ", count, '\n');
+	else
+		String::Append(buffer, name, "_sum ", histogram.sum(), '\n', name, "_count ", count, '\n');
+	return self;
+}
+
+void Metrics::add(const string& name, const Collector& collector) {
+	lock_guard<mutex> lock(_mutex);
+	_collectors[name] = collector;
+}
+
+bool Metrics::remove(const string& name) {
+	lock_guard<mutex> lock(_mutex);
+	return _collectors.erase(name) > 0;
+}
+
+Buffer& Metrics::render(Buffer& buffer, bool http) const {
+	uint32_t offset(buffer.size());
+	{
+		Writer writer(buffer);
+		lock_guard<mutex> lock(_mutex);
+		for (const auto& it : _collectors)
+			it.second(writer);
+	}
+	if (!http)
+		return buffer;
+	String header("HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: ", buffer.size() - offset, "\r\n\r\n");
+	buffer.resize(buffer.size() + header.size());
+	memmove(buffer.data() + offset + header.size(), buffer.data() + offset, buffer.size() - offset - header.size());
+	memcpy(buffer.data() + offset, header.data(), header.size());
+	return buffer;
+}
+
+
+} // namespace Mona
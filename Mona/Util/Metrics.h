@@ -0,0 +1,156 @@
+/*
+This file is a part of MonaSolutions Copyright 2017
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or
+modify it under the terms of the the Mozilla Public License v2.0.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+Mozilla Public License v. 2.0 received along this program for more
+details (or else see http://mozilla.org/MPL/2.0/).
+
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Format/String.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace Mona {
+
+/*!
+Metrics registry rendered in Prometheus text format (version 0.0.4).
+Counter and Histogram are lock-free and sharded by thread to stay cheap on hot paths (no shared cache line between threads),
+the registry mutex is taken only to add/remove a metric and to render */
+struct Metrics : virtual Object {
+	enum Type {
+		TYPE_COUNTER = 0,
+		TYPE_GAUGE,
+		TYPE_HISTOGRAM,
+		TYPE_SUMMARY // quantiles computed by the writer, "name_sum" and "name_count" samples have to be written directly in buffer
+	};
+	enum { SHARDS = 16 };
+
+	/*!
+	Monotonic counter */
+	struct Counter : virtual Object {
+		Counter() { for (Shard& shard : _shards) shard.value = 0; }
+
+		Counter& operator+=(uint64_t value) { _shards[Metrics::Shard()].value.fetch_add(value, std::memory_order_relaxed); return self; }
+		Counter& operator++() { return self += 1; }
+
+		uint64_t operator()() const;
+		operator uint64_t() const { return (*this)(); }
+	private:
+		struct Shard {
+			std::atomic<uint64_t>	value;
+			char					padding[64 - sizeof(std::atomic<uint64_t>)]; // one cache line by shard
+		};
+		Shard _shards[SHARDS];
+	};
+
+	/*!
+	Value which can go up and down */
+	struct Gauge : virtual Object {
+		Gauge(int64_t value = 0) : _value(value) {}
+
+		Gauge& operator=(int64_t value) { _value.store(value, std::memory_order_relaxed); return self; }
+		Gauge& operator+=(int64_t value) { _value.fetch_add(value, std::memory_order_relaxed); return self; }
+		Gauge& operator-=(int64_t value) { _value.fetch_sub(value, std::memory_order_relaxed); return self; }
+
+		int64_t operator()() const { return _value.load(std::memory_order_relaxed); }
+		operator int64_t() const { return (*this)(); }
+	private:
+		std::atomic<int64_t> _value;
+	};
+
+	/*!
+	Distribution of observed values in buckets given by their upper bound (+Inf bucket is implicit) */
+	struct Histogram : virtual Object {
+		enum { MAX_BOUNDS = 254 }; // +Inf bucket index has to fit in a uint8_t lower than 255
+		/*!
+		Default buckets of Prometheus clients, for durations in seconds */
+		Histogram() : Histogram({ 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10 }) {}
+		Histogram(const std::vector<double>& bounds);
+
+		void observe(double value);
+
+		const std::vector<double>& bounds() const { return _bounds; }
+		/*!
+		Observations less or equal to bounds()[bucket], bucket==bounds().size() for +Inf (total count) */
+		uint64_t count(uint8_t bucket) const;
+		uint64_t count() const { return count(uint8_t(_bounds.size())); }
+		double	 sum() const;
+	private:
+		const std::vector<double>			_bounds;
+		const uint32_t						_stride; // slots by shard: counts by bucket + sum, rounded to a cache line
+		std::vector<std::atomic<uint64_t>>	_values;
+	};
+
+	/*!
+	Prometheus text writer, write HELP and TYPE lines on the first sample of each family */
+	struct Writer : virtual Object {
+		Writer(Buffer& buffer) : buffer(buffer) {}
+
+		/*!
+		Write a sample, labels is the content between braces (ex: thread="1") */
+		template<typename ValueType>
+		Writer& write(const std::string& name, Type type, ValueType value, const char* help = NULL, const char* labels = NULL) {
+			family(name, type, help);
+			String::Append(buffer, name);
+			if (labels)
+				String::Append(buffer, '{', labels, '}');
+			String::Append(buffer, ' ', value, '\n');
+			return self;
+		}
+		Writer& write(const std::string& name, const Counter& counter, const char* help = NULL, const char* labels = NULL) { return write(name, TYPE_COUNTER, counter(), help, labels); }
+		Writer& write(const std::string& name, const Gauge& gauge, const char* help = NULL, const char* labels = NULL) { return write(name, TYPE_GAUGE, gauge(), help, labels); }
+		Writer& write(const std::string& name, const Histogram& histogram, const char* help = NULL, const char* labels = NULL);
+
+		Buffer& buffer;
+	private:
+		void family(const std::string& name, Type type, const char* help);
+
+		std::string _family;
+	};
+	typedef std::function<void(Writer& writer)> Collector;
+
+	/*!
+	Add a metric which has to stay alive until its remove, replaces a metric with the same name */
+	template<typename MetricType, typename = typename std::enable_if<std::is_base_of<Object, MetricType>::value>::type>
+	const MetricType& add(const std::string& name, const MetricType& metric, const std::string& help = "") {
+		add(name, [&metric, name, help](Writer& writer) { writer.write(name, metric, help.empty() ? NULL : help.c_str()); });
+		return metric;
+	}
+	/*!
+	Add a collector which writes its samples on rendering (gauges computed on demand, aggregations...) */
+	void add(const std::string& name, const Collector& collector);
+	bool remove(const std::string& name);
+
+	/*!
+	Render all the metrics, with HTTP response headers if http=true to be sent directly on a TCP connection */
+	Buffer& render(Buffer& buffer, bool http = false) const;
+
+	/*!
+	Shard index of the current thread */
+	static uint8_t Shard() {
+		static thread_local uint8_t Index(SHARDS);
+		return Index < SHARDS ? Index : (Index = uint8_t(_Threads++ % SHARDS));
+	}
+private:
+	mutable std::mutex					_mutex;
+	std::map<std::string, Collector>	_collectors;
+
+	static std::atomic<uint32_t>		_Threads;
+};
+
+
+} // namespace Mona
@@ -20,6 +20,7 @@ details (or else see http://mozilla.org/MPL/2.0/).
 #include "Mona/Util/Parameters.h"
 #include "Mona/Threading/Process.h"
 #include "Mona/Disk/Path.h"
+#include "Mona/Format/Codec.h"
 
 namespace Mona {
 
@@ -94,35 +95,11 @@ struct Util : virtual Static {
 
 	template <typename BufferType>
 	static BufferType& ToBase64(const char* data, uint32_t size, BufferType& buffer, bool append=false) {
-		uint32_t accumulator(buffer.size()),bits(0);
-
-		if (!append)
-			accumulator = 0;
-		buffer.resize(accumulator+uint32_t(ceil(size/3.0)*4));
-
-		char* current((char*)buffer.data());
-		if (!current) // to expect null writer 
+		uint32_t oldSize(append ? buffer.size() : 0);
+		buffer.resize(oldSize + uint32_t((size + 2ull) / 3 * 4));
+		if (!buffer.data()) // to expect null writer 
 			return buffer;
-		const char*	end(current+buffer.size());
-		current += accumulator;
-
-		const char* endData = data + size;
-		
-		accumulator = 0;
-		while(data<endData) {
-			accumulator = (accumulator << 8) | (*data++ & 0xFFu);
-			bits += 8;
-			while (bits >= 6) {
-				bits -= 6;
-				*current++ = _B64Table[(accumulator >> bits) & 0x3Fu];
-			}
-		}
-		if (bits > 0) { // Any trailing bits that are missing.
-			accumulator <<= 6 - bits;
-			*current++ = _B64Table[accumulator & 0x3Fu];
-		}
-		while (current<end) // padding with '='
-			*current++ = '=';
+		Codec::ToBase64(data, size, (char*)buffer.data() + oldSize);
 		return buffer;
 	}
 
@@ -135,43 +112,19 @@ struct Util : virtual Static {
 		if (!buffer.data())
 			return false; // to expect null writer 
 
-		uint32_t bits(0), oldSize(append ? buffer.size() : 0);
-		uint32_t accumulator(oldSize + uint32_t(ceil(size / 4.0) * 3));
-		const char* end = data+size;
-
-		if (buffer.size()<accumulator)
-			buffer.resize(accumulator); // maximum size!
-		char* out =  (char*)buffer.data() + oldSize;
-
-		accumulator = size = 0;
-
-		while(data<end) {
-			uint8_t c = *data++;
-			if (isspace(c) || c == '=')
-				continue;
-
-			if ((c > 127) || (_ReverseB64Table[c] > 63)) {
-				// reset the oldSize
-				buffer.resize(oldSize);
-				return false;
-			}
-		
-			accumulator = (accumulator << 6) | _ReverseB64Table[c];
-			bits += 6;
-			if (bits >= 8) {
-				bits -= 8;
-				size++;
-				*out++ = ((accumulator >> bits) & 0xFFu);
-			}
+		uint32_t oldSize(append ? buffer.size() : 0);
+		uint32_t maxSize(oldSize + uint32_t((size + 3ull) / 4 * 3));
+		if (buffer.size()<maxSize)
+			buffer.resize(maxSize); // maximum size!
+		const char* end = Codec::FromBase64(data, size, (char*)buffer.data() + oldSize);
+		if (!end) {
+			// reset the oldSize
+			buffer.resize(oldSize);
+			return false;
 		}
-		buffer.resize(oldSize+size);
+		buffer.resize(end - (const char*)buffer.data());
 		return true;
 	}
-
-
-private:
-	static const char						_B64Table[65];
-	static const char						_ReverseB64Table[128];
 };
 
 } // namespace Mona
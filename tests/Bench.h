@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Mona/Mona.h"
+#include <chrono>
+
+/*!
+Microbenchmark helper of the Benchmarks target (built with MONA_BENCHMARKS, never run by ctest),
+calls count times runner(index) and returns nanoseconds by call.
+Runner results are summed in a volatile sink to keep the compiler from removing the calls */
+template<typename RunnerType>
+static double Bench(uint32_t count, RunnerType&& runner) {
+    static volatile uint64_t Sink;
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < count; ++i)
+        sum += uint64_t(runner(i));
+    double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    Sink += sum;
+    return elapsed / count;
+}
+
+/*!
+Throughput in bytes by nanosecond of a runner processing size bytes by call */
+template<typename RunnerType>
+static double Throughput(uint32_t size, uint32_t count, RunnerType&& runner) {
+    return size / Bench(count, std::forward<RunnerType>(runner));
+}
@@ -0,0 +1,208 @@
+#include "Bench.h"
+#include "References.h"
+#include "Mona/Format/String.h"
+#include "Mona/Util/Util.h"
+#include "Mona/Timing/CoarseClock.h"
+#include "Mona/Util/Exceptions.h"
+#include <random>
+
+using namespace std;
+using namespace Mona;
+
+// Time::Now() against Time::Coarse(), with and without CoarseClock
+static void BenchTime() {
+    double now = Bench(10000000, [](uint32_t) { return Time::Now(); });
+    double disabled = Bench(10000000, [](uint32_t) { return Time::Coarse(); });
+    CoarseClock clock;
+    Thread::Sleep(20); // first refresh
+    double enabled = Bench(10000000, [](uint32_t) { return Time::Coarse(); });
+    printf("Time::Now %.1fns, Time::Coarse %.1fns (%.1fns without CoarseClock)\n", now, enabled, disabled);
+}
+
+// Previous String::tryNumber implementation (long double accumulator), kept as reference
+template<typename Type>
+static bool LegacyTryNumber(const char* value, size_t size, Type& result) {
+    Exception ex;
+    bool beginning = true;
+    uint8_t negative = 0;
+    long double number(0);
+    uint64_t comma(0);
+    const char* current(value);
+    while (*current && size-- > 0) {
+        if (iscntrl(*current) || *current == ' ') {
+            if (!beginning) {
+                ex.set<Ex::Format>(value, " is a partial number");
+                break;
+            }
+            ++current;
+            continue;
+        }
+        if (ispunct(*current)) {
+            switch (*current++) {
+                case '-':
+                    if (beginning)
+                        negative = negative ? 0 : 1;
+                case '+':
+                    if (!beginning) {
+                        ex.set<Ex::Format>(value, " is a partial number");
+                        break;
+                    }
+                    continue;
+                case '.':
+                case ',':
+                    if (beginning || comma) {
+                        ex.set<Ex::Format>(value, " is a partial number");
+                        break;
+                    }
+                    comma = 1;
+                    continue;
+                default:;
+            }
+            ex.set<Ex::Format>(value, " is a partial number");
+            break;
+        }
+        int8_t digit = *current - '0';
+        if (digit > 9)
+            digit -= digit >= 49 ? 39 : 7;
+        if (digit >= 10) {
+            ex.set<Ex::Format>(value, " is a partial number");
+            break;
+        }
+        beginning = false;
+        number = number * 10 + digit;
+        comma *= 10;
+        ++current;
+    }
+    if (beginning) {
+        ex.set<Ex::Format>("Empty string is not a number");
+        return false;
+    }
+    if (comma)
+        number /= comma;
+    if ((number - negative) > numeric_limits<Type>::max())
+        number = numeric_limits<Type>::max() + negative;
+    if (negative)
+        number = is_unsigned<Type>::value ? 0 : -number;
+    result = (Type)number;
+    return true;
+}
+
+// String::tryNumber against its previous implementation
+static void BenchTryNumber() {
+    mt19937_64 random(0);
+    vector<string> integers, doubles;
+    char buffer[64];
+    for (uint32_t i = 0; i < 1000; ++i) {
+        integers.emplace_back(to_string(int64_t(random()) >> (random() % 64)));
+        snprintf(buffer, sizeof(buffer), "%llu.%llu", (unsigned long long)(random() % 1000000), (unsigned long long)random() >> (random() % 64));
+        doubles.emplace_back(buffer);
+    }
+    double legacyInt = Bench(2000000, [&](uint32_t i) { int64_t result(0); return LegacyTryNumber(integers[i % 1000].data(), integers[i % 1000].size(), result) && result; });
+    double newInt = Bench(2000000, [&](uint32_t i) { int64_t result(0); return String::tryNumber(integers[i % 1000].data(), integers[i % 1000].size(), result) && result; });
+    double legacyDouble = Bench(2000000, [&](uint32_t i) { double result(0); return LegacyTryNumber(doubles[i % 1000].data(), doubles[i % 1000].size(), result) && result; });
+    double newDouble = Bench(2000000, [&](uint32_t i) { double result(0); return String::tryNumber(doubles[i % 1000].data(), doubles[i % 1000].size(), result) && result; });
+    printf("String::tryNumber int64 %.1fns (previously %.1fns), double %.1fns (previously %.1fns)\n", newInt, legacyInt, newDouble, legacyDouble);
+}
+
+// String::Append of numbers against snprintf
+static void BenchAppend() {
+    mt19937_64 random(0);
+    vector<int64_t> ints;
+    vector<double> doubles;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        ints.emplace_back(int64_t(random()) >> (random() % 64));
+        doubles.emplace_back(double(int64_t(random()) >> (random() % 64)) / (random() | 1));
+    }
+    char buffer[64];
+    string output;
+    double snprintfInt = Bench(2000000, [&](uint32_t i) { return snprintf(buffer, sizeof(buffer), "%lld", (long long)ints[i % ints.size()]); });
+    double newInt = Bench(2000000, [&](uint32_t i) { output.clear(); return String::Append(output, ints[i % ints.size()]).size(); });
+    double snprintfDouble = Bench(2000000, [&](uint32_t i) { return snprintf(buffer, sizeof(buffer), "%.16g", doubles[i % doubles.size()]); });
+    double newDouble = Bench(2000000, [&](uint32_t i) { output.clear(); return String::Append(output, doubles[i % doubles.size()]).size(); });
+    printf("String::Append int64 %.1fns (snprintf %.1fns), double %.1fns (snprintf %.1fns)\n", newInt, snprintfInt, newDouble, snprintfDouble);
+}
+
+// Crypto::ComputeCRC32 and Crypto::ComputeChecksum against their references
+static void BenchChecksums() {
+    mt19937 random(0);
+    string packet(1 << 20, 0);
+    for (char& byte : packet)
+        byte = char(random());
+    const char* data = packet.data();
+    uint32_t size = uint32_t(packet.size());
+    double crc = Throughput(size, 200, [&](uint32_t) { return Crypto::ComputeCRC32(data, size); });
+    double crcRotated = Throughput(size, 200, [&](uint32_t) { return Crypto::ComputeCRC32(data, size, ROTATE_INPUT); });
+    double crcReference = Throughput(size, 10, [&](uint32_t) { return ReferenceCRC32(data, size, 0); });
+    double checksum = Throughput(size, 200, [&](uint32_t) { return Crypto::ComputeChecksum(data, size); });
+    double checksumReference = Throughput(size, 200, [&](uint32_t) { BinaryReader reader(data, size); return ReferenceChecksum(reader); });
+    printf("Crypto::ComputeCRC32 %.2fB/ns (rotated %.2fB/ns, bitwise %.2fB/ns), Crypto::ComputeChecksum %.2fB/ns (previously %.2fB/ns)\n", crc, crcRotated, crcReference, checksum, checksumReference);
+}
+
+// Crypto::Hash::Context on a fragmented message against the concatenation previously required
+static void BenchHash() {
+    mt19937 random(0);
+    string packet(1 << 20, 0);
+    for (char& byte : packet)
+        byte = char(random());
+    const char* data = packet.data();
+    uint32_t size = uint32_t(packet.size());
+    char value[Crypto::SHA256_SIZE];
+    Crypto::Hash::Context hash(EVP_sha256());
+    double hashRope = Throughput(size, 200, [&](uint32_t) {
+        Rope rope;
+        for (uint32_t position = 0; position < size; position += 1500)
+            rope.append(Packet(data + position, min(1500u, size - position)));
+        return uint8_t(hash.update(rope).final(value)[0]);
+    });
+    double hashCopy = Throughput(size, 200, [&](uint32_t) {
+        Buffer buffer;
+        for (uint32_t position = 0; position < size; position += 1500)
+            buffer.append(data + position, min(1500u, size - position));
+        return uint8_t(Crypto::Hash::SHA256(buffer.data(), buffer.size(), value)[0]);
+    });
+    printf("Crypto::Hash::Context SHA256 on 1500B chunks %.2fB/ns (concatenated before %.2fB/ns)\n", hashRope, hashCopy);
+}
+
+// Base64 and hexadecimal codecs against their previous implementations
+static void BenchCodec() {
+    mt19937 random(0);
+    string blob(1 << 16, 0);
+    for (char& byte : blob)
+        byte = char(random());
+    const char* data = blob.data();
+    uint32_t size = uint32_t(blob.size());
+    string base64(LegacyToBase64(data, size)), hexadecimal(LegacyHex(data, size, false)), result;
+    double toBase64 = Throughput(size, 2000, [&](uint32_t) { return Util::ToBase64(data, size, result).size(); });
+    double legacyToBase64 = Throughput(size, 2000, [&](uint32_t) { return LegacyToBase64(data, size).size(); });
+    double fromBase64 = Throughput(size, 2000, [&](uint32_t) { return Util::FromBase64(base64.data(), base64.size(), result) ? result.size() : 0; });
+    double legacyFromBase64 = Throughput(size, 2000, [&](uint32_t) { return LegacyFromBase64(base64.data(), base64.size(), result) ? result.size() : 0; });
+    double toHex = Throughput(size, 2000, [&](uint32_t) { result.clear(); return String::Append(result, String::Hex(data, size)).size(); });
+    double legacyToHex = Throughput(size, 2000, [&](uint32_t) { return LegacyHex(data, size, false).size(); });
+    double fromHex = Throughput(size, 2000, [&](uint32_t) { return String::ToHex(hexadecimal, result).size(); });
+    double legacyFromHex = Throughput(size, 2000, [&](uint32_t) { return LegacyFromHex(hexadecimal.data(), hexadecimal.size()).size(); });
+    printf("Base64 encoding %.2fB/ns (previously %.2fB/ns), decoding %.2fB/ns (previously %.2fB/ns)\n", toBase64, legacyToBase64, fromBase64, legacyFromBase64);
+    printf("Hexadecimal encoding %.2fB/ns (previously %.2fB/ns), decoding %.2fB/ns (previously %.2fB/ns)\n", toHex, legacyToHex, fromHex, legacyFromHex);
+}
+
+int main(int argc, char** argv) {
+    // Benchmarks to run given by name in arguments, all by default
+    static const struct {
+        const char* name;
+        void (*run)();
+    } Benchmarks[] = {
+        { "Time", BenchTime },
+        { "TryNumber", BenchTryNumber },
+        { "Append", BenchAppend },
+        { "Checksums", BenchChecksums },
+        { "Hash", BenchHash },
+        { "Codec", BenchCodec }
+    };
+    for (const auto& benchmark : Benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+            selected |= String::ICompare(argv[i], benchmark.name) == 0;
+        if (selected)
+            benchmark.run();
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Math/Crypto.h"
+
+namespace Mona {
+
+// Straightforward implementations, references of the optimized ones for tests and Benchmarks
+
+// CRC-32/MPEG-2 computed bit by bit, reference of the table and vectorized implementations
+inline uint32_t ReferenceCRC32(const char* data, uint32_t size, ROTATE_OPTIONS options) {
+    uint32_t crc(0xffffffff);
+    for (uint32_t i = 0; i < size; ++i) {
+        crc ^= uint32_t(options&ROTATE_INPUT ? Crypto::Rotate8(data[i]) : uint8_t(data[i])) << 24;
+        for (uint8_t bit = 0; bit < 8; ++bit)
+            crc = (crc << 1) ^ (crc & 0x80000000 ? 0x04c11db7 : 0);
+    }
+    return options&ROTATE_OUTPUT ? Crypto::Rotate32(crc) : crc;
+}
+
+// Previous Crypto::ComputeChecksum implementation, kept as reference
+inline uint16_t ReferenceChecksum(BinaryReader& reader) {
+    uint32_t sum = 0;
+    uint32_t pos(reader.position());
+    while (reader.available() > 0)
+        sum += reader.available() == 1 ? reader.read8() : reader.read16();
+    reader.reset(pos);
+    sum = (sum >> 16) + (sum & 0xffff);
+    sum += (sum >> 16);
+    return ~sum;
+}
+
+// Byte by byte algorithms of the previous base64 and hexadecimal implementations, kept as references
+static const char B64Table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+inline std::string LegacyToBase64(const char* data, uint32_t size) {
+    std::string result(uint32_t(std::ceil(size / 3.0) * 4), '=');
+    char* current(&result[0]);
+    uint32_t accumulator(0), bits(0);
+    for (const char* end = data + size; data < end;) {
+        accumulator = (accumulator << 8) | (*data++ & 0xFFu);
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            *current++ = B64Table[(accumulator >> bits) & 0x3Fu];
+        }
+    }
+    if (bits > 0)
+        *current++ = B64Table[(accumulator << (6 - bits)) & 0x3Fu];
+    return result;
+}
+inline bool LegacyFromBase64(const char* data, uint32_t size, std::string& result) {
+    static char ReverseB64Table[128];
+    if (!ReverseB64Table[0]) {
+        std::memset(ReverseB64Table, 64, sizeof(ReverseB64Table));
+        for (uint8_t i = 0; i < 64; ++i)
+            ReverseB64Table[uint8_t(B64Table[i])] = i;
+    }
+    result.resize(uint32_t(std::ceil(size / 4.0) * 3));
+    char* out(&result[0]);
+    uint32_t accumulator(0), bits(0);
+    for (const char* end = data + size; data < end;) {
+        uint8_t c = *data++;
+        if (std::isspace(c) || c == '=')
+            continue;
+        if ((c > 127) || (ReverseB64Table[c] > 63)) {
+            result.clear();
+            return false;
+        }
+        accumulator = (accumulator << 6) | ReverseB64Table[c];
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            *out++ = char((accumulator >> bits) & 0xFFu);
+        }
+    }
+    result.resize(out - result.data());
+    return true;
+}
+inline std::string LegacyFromHex(const char* value, size_t size) {
+    std::string result((size + 1) / 2, 0);
+    char* out(&result[0]);
+    while (size-- > 0) {
+        char left = std::toupper(*value++);
+        char right = size ? (--size, std::toupper(*value++)) : '0'; // previously size-- overflowed with an odd size
+        *out++ = char((U(left - (left <= '9' ? '0' : '7')) << 4) | ((right - (right <= '9' ? '0' : '7')) & 0x0F));
+    }
+    return result;
+}
+inline std::string LegacyHex(const char* data, uint32_t size, bool upperCase) {
+    std::string result;
+    for (const char* end = data + size; data < end; ++data) {
+        char value = U(*data) >> 4;
+        result += char(value + (value > 9 ? (upperCase ? '7' : 'W') : '0'));
+        value = *data & 0x0F;
+        result += char(value + (value > 9 ? (upperCase ? '7' : 'W') : '0'));
+    }
+    return result;
+}
+
+} // namespace Mona
@@ -0,0 +1,66 @@
+#include "Mona/Mona.h"
+#include "Mona/Logs/BinaryLog.h"
+#include "Mona/Logs/Logs.h"
+
+using namespace std;
+using namespace Mona;
+
+// Decode(Encode(args)) must give the String::Append text of args
+template<typename ...Args>
+static bool RoundTrip(Args&&... args) {
+    Buffer buffer;
+    BinaryLog::Encode(buffer, args...);
+    string message;
+    return BinaryLog::Decode(buffer.data(), buffer.size(), message) && message == String(args...);
+}
+
+int main(int argc, char** argv) {
+    // Integer limits, signed values beyond 2^62 included
+    CHECK(RoundTrip(numeric_limits<int64_t>::max(), ' ', numeric_limits<int64_t>::min(), ' ', int64_t(1) << 62, ' ', -(int64_t(1) << 62), ' ', (int64_t(1) << 62) - 1));
+    CHECK(RoundTrip(numeric_limits<long long>::max(), ' ', numeric_limits<long long>::min(), ' ', numeric_limits<long>::min(), ' ', -1, ' ', 0, ' ', 1));
+    CHECK(RoundTrip(numeric_limits<int>::min(), ' ', numeric_limits<int>::max(), ' ', numeric_limits<short>::min(), ' ', numeric_limits<short>::max(), ' ', (signed char)-128, ' ', (signed char)127));
+    CHECK(RoundTrip(numeric_limits<uint64_t>::max(), ' ', numeric_limits<unsigned long long>::max(), ' ', numeric_limits<uint32_t>::max(), ' ', (unsigned short)65535, ' ', (unsigned char)255, ' ', 0u));
+    for (int shift = 0; shift < 64; ++shift) {
+        uint64_t value = uint64_t(1) << shift;
+        CHECK(RoundTrip(int64_t(value), ' ', int64_t(0 - value), ' ', int64_t(value - 1), ' ', value));
+    }
+
+    // char, bool, float, double and strings
+    CHECK(RoundTrip('a', ' ', '\0', ' ', true, ' ', false));
+    CHECK(RoundTrip(0.1f, ' ', -1e-5f, ' ', numeric_limits<float>::max(), ' ', numeric_limits<float>::denorm_min()));
+    CHECK(RoundTrip(0.1 + 0.2, ' ', -0.0, ' ', 5e-324, ' ', numeric_limits<double>::max(), ' ', numeric_limits<double>::infinity()));
+    CHECK(RoundTrip("text ", string("std::string "), string(), nullptr, ' ', String("formatted on encoding")));
+    string message;
+    CHECK(BinaryLog::Decode(EXPC("\xFF"), message) == false); // unknown type
+
+    // Logs stream back to the text written by FileLogger
+    BinaryLog::Writer writer;
+    Buffer stream, args, expected;
+    int64_t time = 1700000000123ll;
+    BinaryLog::Encode(args, "min ", numeric_limits<int64_t>::min(), ", max ", numeric_limits<uint64_t>::max(), ' ', true);
+    writer.write(stream, LOG_INFO, "tests/TestBinaryLog.cpp", 42, 7, time, Packet(args.data(), args.size()));
+    String::Append(expected, String::Log(Logs::LevelToString(LOG_INFO), "tests/TestBinaryLog.cpp", 42, String("min ", numeric_limits<int64_t>::min(), ", max ", numeric_limits<uint64_t>::max(), ' ', true), 7, time));
+    BinaryLog::Encode(args.clear(), 'x', 1.5, -2.5f);
+    writer.write(stream, LOG_ERROR, "Mona/Logs/Logs.cpp", 1, 0, time - 5000, Packet(args.data(), args.size())); // time back
+    String::Append(expected, String::Log(Logs::LevelToString(LOG_ERROR), "Mona/Logs/Logs.cpp", 1, "x1.5-2.5", 0, time - 5000));
+    writer.write(stream, time + 1, "dump", EXPC("\x00\x01 binary"));
+    String::Append(Date(time + 1).format("%d/%m %H:%M:%S.%c  ", expected), "dump\n");
+    expected.append(EXPC("\x00\x01 binary"));
+    BinaryLog::Encode(args.clear(), false);
+    writer.write(stream, LOG_DEBUG, "tests/TestBinaryLog.cpp", 0, 0, time + 2, Packet(args.data(), args.size()));
+    String::Append(expected, String::Log(Logs::LevelToString(LOG_DEBUG), "tests/TestBinaryLog.cpp", 0, "false", 0, time + 2));
+    Buffer text;
+    CHECK(BinaryLog::ToText(stream.data(), stream.size(), text));
+    CHECK(string(text.data(), text.size()) == string(expected.data(), expected.size()));
+
+    // A new stream appended (new process) and a truncated stream
+    writer.reset();
+    uint32_t size = stream.size();
+    BinaryLog::Encode(args.clear(), -1);
+    writer.write(stream, LOG_WARN, "tests/TestBinaryLog.cpp", 3, 0, time, Packet(args.data(), args.size()));
+    String::Append(expected, String::Log(Logs::LevelToString(LOG_WARN), "tests/TestBinaryLog.cpp", 3, "-1", 0, time));
+    CHECK(BinaryLog::ToText(stream.data(), stream.size(), text.clear()));
+    CHECK(string(text.data(), text.size()) == string(expected.data(), expected.size()));
+    CHECK(!BinaryLog::ToText(stream.data() + 1, size - 1, text.clear()));
+    return 0;
+}
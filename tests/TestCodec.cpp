@@ -0,0 +1,80 @@
+#include "Mona/Mona.h"
+#include "Mona/Util/Util.h"
+#include "Mona/Format/String.h"
+#include "References.h"
+#include <random>
+
+using namespace std;
+using namespace Mona;
+
+static bool CheckFromBase64(const string& encoded) {
+    string expected, result;
+    bool valid = LegacyFromBase64(encoded.data(), encoded.size(), expected);
+    if (Util::FromBase64(encoded.data(), encoded.size(), result) != valid)
+        return false;
+    if (!valid)
+        return result.empty();
+    Buffer buffer(encoded.data(), encoded.size()); // in-place
+    return result == expected && Util::FromBase64(buffer) && string(buffer.data(), buffer.size()) == expected;
+}
+
+int main(int argc, char** argv) {
+    // Known values
+    string value;
+    CHECK(Util::ToBase64(EXPC("Man"), value) == "TWFu" && Util::ToBase64(EXPC("Ma"), value) == "TWE=" && Util::ToBase64(EXPC("M"), value) == "TQ==");
+    CHECK(Util::ToBase64(EXPC("!"), value, true) == "TQ==IQ==");
+    CHECK(Util::FromBase64(EXPC("TWFu\r\nTWE= "), value) && value == "ManMa");
+    CHECK(Util::FromBase64(EXPC("TQ"), value) && value == "M"); // padding optional
+    CHECK(!Util::FromBase64(EXPC("TW-u"), value) && value.empty());
+    CHECK(String::ToHex(EXPC("4d6F6e61"), value) == "Mona" && String::ToHex(EXPC("4d6"), value) == "M`");
+    CHECK(String(String::Hex(EXPC("\x01\xAB"))) == "01ab" && String(String::Hex(EXPC("\x01\xAB"), HEX_UPPER_CASE | HEX_TRIM_LEFT)) == "1AB");
+    CHECK(String(String::Hex(EXPC("\x00\x0F\xAB"), HEX_CPP | HEX_TRIM_LEFT)) == "\\xf\\xab");
+
+    // Equivalence on every size and alignment around vectorized blocks
+    mt19937 random(0);
+    string data(512, 0);
+    for (char& byte : data)
+        byte = char(random());
+    for (uint32_t offset = 0; offset < 32; ++offset) {
+        for (uint32_t size = 0; size <= 300; ++size) {
+            const char* bytes = data.data() + offset;
+            string encoded(LegacyToBase64(bytes, size));
+            CHECK(Util::ToBase64(bytes, size, value) == encoded);
+            CHECK(Util::FromBase64(value) && value == string(bytes, size));
+            CHECK(CheckFromBase64(encoded));
+            for (bool upperCase : { false, true }) {
+                string hex(LegacyHex(bytes, size, upperCase));
+                CHECK(String(String::Hex(bytes, size, upperCase ? HEX_UPPER_CASE : 0)) == hex);
+                Buffer buffer;
+                String::Append(buffer, String::Hex(bytes, size, upperCase ? HEX_UPPER_CASE : 0));
+                CHECK(string(buffer.data(), buffer.size()) == hex);
+                CHECK(String::ToHex(hex, value) == string(bytes, size));
+                CHECK(String::ToHex(bytes, size, value) == LegacyFromHex(bytes, size)); // not hexadecimal
+                hex.resize(hex.size() - (size & 1)); // odd digits count
+                CHECK(String::ToHex(hex, value) == LegacyFromHex(hex.data(), hex.size()));
+                CHECK(String::ToHex(hex) == LegacyFromHex(hex.data(), hex.size())); // in-place
+            }
+        }
+    }
+
+    // Every byte value at every position of a vectorized block, and random spaces, padding or invalid characters
+    string encoded(LegacyToBase64(data.data(), 96)), hex(LegacyHex(data.data(), 64, false));
+    for (uint32_t position = 0; position < 128; ++position) {
+        for (uint32_t byte = 0; byte < 256; ++byte) {
+            string altered(encoded);
+            altered[position] = char(byte);
+            CHECK(CheckFromBase64(altered));
+            altered = hex;
+            altered[position] = char(byte);
+            CHECK(String::ToHex(altered, value) == LegacyFromHex(altered.data(), altered.size()));
+        }
+    }
+    const char specials[] = " \t\r\n=-.\x80\xFF";
+    for (uint32_t i = 0; i < 20000; ++i) {
+        string altered(LegacyToBase64(data.data(), random() % 256));
+        for (uint32_t count = random() % 4; count > 0; --count)
+            altered.insert(altered.begin() + random() % (altered.size() + 1), specials[random() % (sizeof(specials) - 1)]);
+        CHECK(CheckFromBase64(altered));
+    }
+    return 0;
+}
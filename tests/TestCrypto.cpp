@@ -0,0 +1,77 @@
+#include "Mona/Mona.h"
+#include "Mona/Math/Crypto.h"
+#include "Mona/Format/String.h"
+#include "References.h"
+#include <random>
+
+using namespace std;
+using namespace Mona;
+
+// Compare a digest to its hexadecimal representation
+static bool Equals(const char* value, const char* hex) {
+    string binary;
+    String::ToHex(hex, strlen(hex), binary);
+    return memcmp(value, binary.data(), binary.size()) == 0;
+}
+
+int main(int argc, char** argv) {
+    // Known values
+    CHECK(Crypto::ComputeCRC32(EXPC("123456789")) == 0x0376E6E7); // CRC-32/MPEG-2 check value
+    CHECK(Crypto::ComputeCRC32(EXPC("123456789"), ROTATE_INPUT | ROTATE_OUTPUT) == ~0xCBF43926u); // zlib crc32
+    CHECK(Crypto::ComputeCRC32(NULL, 0) == 0xFFFFFFFF);
+    const char header[] = { 0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11, 0x00, 0x00, char(0xc0), char(0xa8), 0x00, 0x01, char(0xc0), char(0xa8), 0x00, char(0xc7) };
+    CHECK(Crypto::ComputeChecksum(header, sizeof(header)) == 0xB861); // IPv4 header sample
+    CHECK(Crypto::ComputeChecksum(NULL, 0) == 0xFFFF);
+
+    // Equivalence on every size, alignment and option around vectorized blocks
+    mt19937 random(0);
+    string data(4096 + 64, 0);
+    for (char& byte : data)
+        byte = char(random());
+    for (uint32_t offset = 0; offset < 16; ++offset) {
+        for (uint32_t size = 0; size <= 1100; ++size) {
+            const char* bytes = data.data() + offset;
+            for (ROTATE_OPTIONS options = 0; options < 4; ++options)
+                CHECK(Crypto::ComputeCRC32(bytes, size, options) == ReferenceCRC32(bytes, size, options));
+            BinaryReader reader(bytes, size);
+            CHECK(Crypto::ComputeChecksum(reader) == ReferenceChecksum(reader) && !reader.position());
+            BinaryReader littleEndian(bytes, size, Bytes::ORDER_LITTLE_ENDIAN);
+            CHECK(Crypto::ComputeChecksum(littleEndian) == ReferenceChecksum(littleEndian));
+        }
+    }
+    for (uint32_t size : { 2048u, 4095u, 4096u }) {
+        for (ROTATE_OPTIONS options = 0; options < 4; ++options)
+            CHECK(Crypto::ComputeCRC32(data.data(), size, options) == ReferenceCRC32(data.data(), size, options));
+    }
+    string saturated(8192, char(0xFF)); // one's complement sum with many carries
+    BinaryReader reader(saturated.data(), saturated.size());
+    CHECK(Crypto::ComputeChecksum(reader) == ReferenceChecksum(reader));
+
+    // Streaming hash and HMAC on scatter lists
+    char value[Crypto::SHA256_SIZE], expected[Crypto::SHA256_SIZE];
+    Crypto::Hash::Context hash(EVP_sha256());
+    CHECK(hash.size() == Crypto::SHA256_SIZE);
+    CHECK(Equals(hash.update(EXPC("abc")).final(value), "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD"));
+    CHECK(Equals(hash.final(value), "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855")); // restarted, empty message
+    vector<Packet> packets;
+    Rope rope;
+    for (uint32_t position = 0; position < data.size(); position += 1 + position % 97) {
+        packets.emplace_back(Packet(data.data() + position, min<uint32_t>(1 + position % 97, uint32_t(data.size()) - position)));
+        rope.append(packets.back());
+    }
+    Crypto::Hash::SHA256(data.data(), data.size(), expected);
+    CHECK(memcmp(hash.update(packets).final(value), expected, sizeof(value)) == 0);
+    CHECK(memcmp(hash.update(rope).final(value), expected, sizeof(value)) == 0);
+    CHECK(memcmp(hash.update(data.data(), 100).update(Packet(data.data() + 100, data.size() - 100)).final(value), expected, sizeof(value)) == 0);
+    CHECK(memcmp(hash.init(EVP_sha1()).update(rope).final(value), Crypto::Hash::SHA1(data.data(), data.size(), expected), Crypto::SHA1_SIZE) == 0);
+    CHECK(hash.size() == Crypto::SHA1_SIZE);
+    Crypto::HMAC::Context hmac(EVP_sha256(), EXPC("key"));
+    CHECK(Equals(hmac.update(EXPC("The quick brown fox jumps over the lazy dog")).final(value), "F7BC83F430538424B13298E6AA6FB143EF4D59A14946175997479DBC2D1A3CD8"));
+    Crypto::HMAC::SHA256(EXPC("key"), data.data(), data.size(), expected);
+    for (uint32_t i = 0; i < 2; ++i) // final() restarts with the same key
+        CHECK(memcmp(hmac.update(rope).final(value), expected, sizeof(value)) == 0);
+    CHECK(memcmp(hmac.init(EVP_md5(), EXPC("other")).update(packets).final(value), Crypto::HMAC::MD5(EXPC("other"), data.data(), data.size(), expected), Crypto::MD5_SIZE) == 0);
+    CHECK(Equals(hmac.init(EVP_md5(), EXPC("Jefe")).update(EXPC("what do ya want for nothing?")).final(value), "750C783E6AB0B503EAA86E310A5DB738")); // same algorithm, other key
+    CHECK(Equals(hmac.init(EVP_sha256(), EXPC("key")).update(EXPC("The quick brown fox jumps over the lazy dog")).final(value), "F7BC83F430538424B13298E6AA6FB143EF4D59A14946175997479DBC2D1A3CD8"));
+    return 0;
+}
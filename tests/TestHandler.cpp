@@ -0,0 +1,57 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/Handler.h"
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+struct Counter : Runner, virtual Object {
+    Counter(atomic<uint32_t>& ran) : Runner("Counter"), _ran(ran) {}
+    bool run(Exception& ex) { ++_ran; return true; }
+private:
+    atomic<uint32_t>& _ran;
+};
+
+int main(int argc, char** argv) {
+    // Producers race with the last flush: every runner accepted by tryQueue must be run,
+    // and the signal can be deleted as soon as flush(true) returns
+    for (uint32_t round = 0; round < 1000; ++round) {
+        Unique<Signal> pSignal(SET);
+        Handler handler(*pSignal);
+        atomic<uint32_t> queued(0), ran(0);
+        vector<thread> producers;
+        for (uint32_t i = 0; i < 3; ++i) {
+            producers.emplace_back([&]() {
+                while (handler.tryQueue<Counter>(ran)) {
+                    ++queued;
+                    this_thread::yield(); // let the consumer flush
+                }
+            });
+        }
+        for (uint32_t i = 0; i < 20; ++i) {
+            pSignal->wait(1);
+            handler.flush();
+            this_thread::yield();
+        }
+        handler.flush(true);
+        pSignal.reset();
+        uint32_t flushed = ran;
+        for (thread& producer : producers)
+            producer.join();
+        CHECK(ran == flushed); // nothing run after the last flush
+        CHECK(ran == queued);
+        CHECK(!handler.tryQueue<Counter>(ran));
+    }
+
+    // A handler reset accepts runners again
+    Signal signal;
+    Handler handler;
+    atomic<uint32_t> ran(0);
+    CHECK(!handler.tryQueue<Counter>(ran));
+    handler.reset(signal);
+    CHECK(handler.tryQueue<Counter>(ran) && handler.tryQueue<Counter>(ran));
+    CHECK(signal.wait(0));
+    CHECK(handler.flush() == 2 && ran == 2);
+    return 0;
+}
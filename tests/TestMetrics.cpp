@@ -0,0 +1,77 @@
+#include "Mona/Mona.h"
+#include "Mona/Util/Metrics.h"
+#include <thread>
+
+using namespace std;
+using namespace Mona;
+
+static string Text(const Buffer& buffer) { return string(buffer.data(), buffer.size()); }
+
+int main(int argc, char** argv) {
+    // Counter summed over the shards of several threads
+    Metrics::Counter counter;
+    vector<thread> threads;
+    for (uint8_t i = 0; i < 4; ++i) {
+        threads.emplace_back([&counter]() {
+            for (uint32_t j = 0; j < 10000; ++j)
+                ++counter;
+            counter += 5;
+        });
+    }
+    for (thread& thread : threads)
+        thread.join();
+    CHECK(counter() == 40020);
+
+    // Histogram buckets are cumulative, bounds are inclusive
+    Metrics::Histogram histogram({ 1, 2.5, 5 });
+    for (double value : { 0.5, 1.0, 1.5, 3.0, 10.0 })
+        histogram.observe(value);
+    CHECK(histogram.count(0) == 2 && histogram.count(1) == 3 && histogram.count(2) == 4 && histogram.count() == 5);
+    CHECK(histogram.sum() == 16);
+    Metrics::Histogram largest(vector<double>(Metrics::Histogram::MAX_BOUNDS, 1));
+    largest.observe(2);
+    CHECK(largest.count(Metrics::Histogram::MAX_BOUNDS - 1) == 0 && largest.count() == 1);
+
+    // Rendering, by name order, HELP and TYPE once by family
+    Metrics metrics;
+    Metrics::Gauge gauge(-3);
+    metrics.add("requests_total", counter, "Requests");
+    metrics.add("latency_seconds", histogram);
+    metrics.add("threads", [&gauge, &histogram](Metrics::Writer& writer) {
+        writer.write("threads", gauge, "Threads", "pool=\"io\"");
+        writer.write("threads", Metrics::TYPE_GAUGE, 7, NULL, "pool=\"disk\"");
+        writer.write("threads_latency_seconds", histogram, NULL, "pool=\"io\"");
+    });
+    const char* expected = "# TYPE latency_seconds histogram\n"
+        "latency_seconds_bucket{le=\"1\"} 2\n"
+        "latency_seconds_bucket{le=\"2.5\"} 3\n"
+        "latency_seconds_bucket{le=\"5\"} 4\n"
+        "latency_seconds_bucket{le=\"+Inf\"} 5\n"
+        "latency_seconds_sum 16\n"
+        "latency_seconds_count 5\n"
+        "# HELP requests_total Requests\n"
+        "# TYPE requests_total counter\n"
+        "requests_total 40020\n"
+        "# HELP threads Threads\n"
+        "# TYPE threads gauge\n"
+        "threads{pool=\"io\"} -3\n"
+        "threads{pool=\"disk\"} 7\n"
+        "# TYPE threads_latency_seconds histogram\n"
+        "threads_latency_seconds_bucket{pool=\"io\",le=\"1\"} 2\n"
+        "threads_latency_seconds_bucket{pool=\"io\",le=\"2.5\"} 3\n"
+        "threads_latency_seconds_bucket{pool=\"io\",le=\"5\"} 4\n"
+        "threads_latency_seconds_bucket{pool=\"io\",le=\"+Inf\"} 5\n"
+        "threads_latency_seconds_sum{pool=\"io\"} 16\n"
+        "threads_latency_seconds_count{pool=\"io\"} 5\n";
+    Buffer buffer;
+    CHECK(Text(metrics.render(buffer)) == expected);
+
+    // HTTP response appended after the content already in buffer
+    buffer.clear().append(EXPC("previous"));
+    metrics.render(buffer, true);
+    CHECK(Text(buffer) == String("previousHTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: ", strlen(expected), "\r\n\r\n", expected));
+
+    CHECK(metrics.remove("threads") && !metrics.remove("threads"));
+    CHECK(Text(metrics.render(buffer.clear())).find("threads") == string::npos);
+    return 0;
+}
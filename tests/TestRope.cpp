@@ -0,0 +1,89 @@
+#include "Mona/Mona.h"
+#include "Mona/Memory/Rope.h"
+#include "Mona/Net/StreamData.h"
+
+using namespace std;
+using namespace Mona;
+
+static string Text(const Packet& packet) { return string(packet.data(), packet.size()); }
+
+static string Text(const Rope& rope) {
+    string text(rope.size(), 0);
+    CHECK(rope.copy(0, &text[0], rope.size()) == rope.size());
+    return text;
+}
+
+// Frames "<size byte><payload>", parsed from the Rope when a rest is kept
+struct Frames : StreamData<> {
+    vector<string> frames;
+private:
+    uint32_t onStreamData(Packet& buffer) {
+        Rope rope;
+        return onStreamData(rope.append(buffer));
+    }
+    uint32_t onStreamData(Rope& rope) {
+        while (rope.size() && rope.size() > rope[0]) {
+            Packet frame(rope.front(rope[0] + 1));
+            frames.emplace_back(frame.data() + 1, frame.size() - 1);
+            rope.clip(frame.size());
+        }
+        return rope.size();
+    }
+};
+
+int main(int argc, char** argv) {
+    // front across chunks, without copy when in one chunk
+    Rope rope;
+    Shared<Buffer> pBuffer(SET, "buffered", 8);
+    rope.append("abc").append(Packet(pBuffer)).append("defg");
+    CHECK(rope.size() == 15 && rope.count() == 3);
+    const char* data(rope.front(2).data());
+    CHECK(Text(rope.front(2)) == "ab" && rope.count() == 3); // in the first chunk
+    CHECK(Text(rope.front(5)) == "abcbu" && rope.count() == 3); // materialized in front
+    CHECK(rope.front(2).data() != data && Text(rope.front(2)) == "ab");
+    CHECK(Text(rope.front()) == "abcbuffereddefg" && rope.count() == 1);
+    CHECK(rope[0] == 'a' && rope[14] == 'g');
+
+    // clip on a materialized buffer held by user keeps its content
+    Packet held(rope.front(6));
+    rope.clip(4);
+    CHECK(Text(held) == "abcbuf" && Text(rope) == "uffereddefg");
+    rope.append("hij");
+    CHECK(Text(rope.front(12)) == "uffereddefgh" && Text(held) == "abcbuf");
+    rope.clip(11);
+    CHECK(Text(rope) == "hij" && rope.count() == 2);
+    rope.clip(3);
+    CHECK(!rope && rope.count() == 0);
+
+    // copy from offset across chunks
+    rope.append("012").append("345").append("6789");
+    char copied[6];
+    CHECK(rope.copy(2, copied, sizeof(copied)) == 6 && memcmp(copied, "234567", 6) == 0);
+    CHECK(rope.copy(8, copied, sizeof(copied)) == 2 && memcmp(copied, "89", 2) == 0);
+    CHECK(rope.copy(10, copied, sizeof(copied)) == 0);
+
+    // bufferize copies unbuffered chunks and small parts of big buffers
+    string unbuffered("temporary");
+    Shared<Buffer> pBig(SET, 1024);
+    memset(pBig->data(), 'x', pBig->size());
+    Shared<Buffer> pCaptured(pBig); // captured by the Packet, pBig kept to check that rope holds a copy
+    rope.clear().append(Packet(unbuffered.data(), unbuffered.size())).append(Packet(pCaptured, pCaptured->data(), 10));
+    rope.bufferize();
+    unbuffered.assign(unbuffered.size(), '-');
+    pBig->data()[0] = 'y';
+    CHECK(Text(rope) == "temporaryxxxxxxxxxx");
+
+    // StreamData, frames split and grouped in any way
+    string stream;
+    for (uint8_t size = 0; size < 20; ++size)
+        stream.append(1, char(size)).append(size, char('a' + size));
+    for (uint32_t step = 1; step <= stream.size(); ++step) {
+        Frames frames;
+        for (uint32_t offset = 0; offset < stream.size(); offset += step)
+            CHECK(frames.addStreamData(Packet(stream.data() + offset, min<uint32_t>(step, stream.size() - offset)), 0xFFFF));
+        CHECK(frames.frames.size() == 20);
+        for (uint8_t size = 0; size < 20; ++size)
+            CHECK(frames.frames[size] == string(size, char('a' + size)));
+    }
+    return 0;
+}
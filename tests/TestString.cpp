@@ -0,0 +1,94 @@
+#include "Mona/Mona.h"
+#include "Mona/Format/String.h"
+#include "Mona/Util/Exceptions.h"
+#include <random>
+
+using namespace std;
+using namespace Mona;
+
+int main(int argc, char** argv) {
+    // Integers
+    CHECK(String::toNumber<int>("42") == 42);
+    CHECK(String::toNumber<int>("  \t-42") == -42);
+    CHECK(String::toNumber<int>("+7") == 7);
+    CHECK(String::toNumber<int>("--5") == 5); // double -- = +
+    CHECK(String::toNumber<int>("12.9") == 12);
+    CHECK(String::toNumber<int>("-12.9") == -12);
+    CHECK(String::toNumber<uint32_t>("-1") == 0);
+    CHECK(String::toNumber<short>("100000") == 32767);
+    CHECK(String::toNumber<short>("-100000") == -32768);
+    CHECK(String::toNumber<uint64_t>("18446744073709551615") == 0xFFFFFFFFFFFFFFFFull);
+    CHECK(String::toNumber<uint64_t>("18446744073709551616") == 0xFFFFFFFFFFFFFFFFull);
+    CHECK(String::toNumber<int64_t>("-9223372036854775808") == numeric_limits<int64_t>::min());
+    CHECK(String::toNumber<int64_t>("123456789012345678") == 123456789012345678ll);
+    CHECK(String::toNumber<bool>("0.5") && !String::toNumber<bool>("0") && String::toNumber<bool>("2"));
+    CHECK(String::toNumber<int>("1234", 2, 0) == 12); // size
+
+    // Errors and partial conversions
+    int value;
+    {
+        Exception ex;
+        CHECK(!String::tryNumber(ex, "", value) && ex);
+    }
+    CHECK(!String::tryNumber("-", value));
+    CHECK(!String::tryNumber(".5", value));
+    CHECK(!String::tryNumber("abc", value));
+    {
+        Exception ex;
+        CHECK(String::tryNumber(ex, "12abc", value) && value == 12 && ex);
+    }
+    {
+        Exception ex;
+        CHECK(String::tryNumber(ex, "12 ", value) && value == 12 && ex);
+    }
+    {
+        Exception ex;
+        CHECK(String::tryNumber(ex, "12", value) && value == 12 && !ex);
+    }
+
+    // Floating points, exact (same result as strtod)
+    CHECK(String::toNumber<double>("0.1") == 0.1);
+    CHECK(String::toNumber<double>("1,5") == 1.5);
+    CHECK(String::toNumber<double>("-3.14159") == -3.14159);
+    CHECK(String::toNumber<double>("5.") == 5);
+    CHECK(String::toNumber<float>("0.3") == 0.3f);
+    CHECK(String::toNumber<double>("1" + string(400, '0')) == numeric_limits<double>::max());
+    CHECK(String::toNumber<double>("0." + string(400, '0') + "1") == 0);
+    mt19937_64 random(0);
+    char buffer[64];
+    for (uint32_t i = 0; i < 100000; ++i) {
+        snprintf(buffer, sizeof(buffer), "%llu.%llu", (unsigned long long)(random() % 1000000), (unsigned long long)random() >> (random() % 64));
+        CHECK(String::toNumber<double>(buffer) == strtod(buffer, NULL));
+        CHECK(String::toNumber<float>(buffer) == strtof(buffer, NULL));
+        snprintf(buffer, sizeof(buffer), "%.*f", int(random() % 20), double(int64_t(random())) / (random() | 1));
+        CHECK(String::toNumber<double>(buffer) == strtod(buffer, NULL));
+    }
+
+    // Integer formatting
+    CHECK(String(0, ' ', -1, ' ', 42u, ' ', (signed char)-128, ' ', (unsigned short)65535) == "0 -1 42 -128 65535");
+    CHECK(String(numeric_limits<int64_t>::min(), ' ', numeric_limits<uint64_t>::max()) == "-9223372036854775808 18446744073709551615");
+    for (uint32_t i = 0; i < 100000; ++i) {
+        int64_t number = int64_t(random()) >> (random() % 64);
+        CHECK(String(number) == to_string(number));
+    }
+    Buffer bytes("abc", 3);
+    String::Append(bytes, 1234, ' ', -0.5);
+    CHECK(string(bytes.data(), bytes.size()) == "abc1234 -0.5");
+
+    // Floating point formatting, shortest representation which converts back with the %g layout
+    CHECK(String(0.1, ' ', 1.5, ' ', -0.0, ' ', 100.0, ' ', 1e15, ' ', 1e16, ' ', 1e-5, ' ', 0.0001) == "0.1 1.5 -0 100 1000000000000000 1e+16 1e-05 0.0001");
+    CHECK(String(0.1 + 0.2, ' ', 5e-324, ' ', numeric_limits<double>::max()) == "0.30000000000000004 5e-324 1.7976931348623157e+308");
+    CHECK(String(0.1f, ' ', 1.0f / 3, ' ', 123456792.0f, ' ', 1e-5f) == "0.1 0.33333334 1.2345679e+08 1e-05");
+    CHECK(String(numeric_limits<double>::infinity(), ' ', -numeric_limits<double>::infinity(), ' ', numeric_limits<double>::quiet_NaN()) == "inf -inf nan");
+    for (uint32_t i = 0; i < 100000; ++i) {
+        uint64_t bits = random();
+        double number;
+        memcpy(&number, &bits, sizeof(number));
+        if (!isfinite(number))
+            continue;
+        String value(number);
+        CHECK(strtod(value.c_str(), NULL) == number);
+        CHECK(value.size() <= 24);
+    }
+    return 0;
+}
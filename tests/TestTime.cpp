@@ -0,0 +1,22 @@
+#include "Mona/Mona.h"
+#include "Mona/Timing/CoarseClock.h"
+
+using namespace std;
+using namespace Mona;
+
+int main(int argc, char** argv) {
+    // Without CoarseClock, Coarse() is Now()
+    CHECK(Mona::abs(Time::Coarse() - Time::Now()) <= 1);
+
+    {
+        CoarseClock clock;
+        int64_t coarse = Time::Coarse();
+        Thread::Sleep(20);
+        CHECK(Time::Coarse() > coarse); // refreshed by the CoarseClock thread
+        // precision of the clock period, with a large margin for loaded machines
+        CHECK(Mona::abs(Time::Now() - Time::Coarse()) < 100);
+    }
+    // Back to Now() once the last CoarseClock deleted
+    CHECK(Mona::abs(Time::Coarse() - Time::Now()) <= 1);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "Mona/Mona.h"
+#include "Mona/Timing/Timer.h"
+#include "Mona/Threading/Thread.h"
+#include <algorithm>
+
+using namespace std;
+using namespace Mona;
+
+// Raise the timer until empty, sleeping the time returned
+static void Run(Timer& timer) {
+    while (uint32_t timeout = timer.raise())
+        Thread::Sleep(timeout);
+}
+
+int main(int argc, char** argv) {
+    static const int64_t Margin(200); // lateness tolerated on loaded machines
+
+    // Cascade across levels: 64ms by slot on level 1 and 4096ms by slot on level 2
+    {
+        Timer timer;
+        vector<uint32_t> timeouts({ 5000, 1, 4097, 63, 130, 64, 4095, 65 });
+        vector<uint32_t> raised;
+        vector<Unique<Timer::OnTimer>> onTimers;
+        int64_t start(Time::Now());
+        for (uint32_t timeout : timeouts) {
+            onTimers.emplace_back(new Timer::OnTimer([&, timeout, start](uint32_t delay) {
+                int64_t elapsed(Time::Now() - start);
+                CHECK(elapsed >= timeout && elapsed <= timeout + Margin);
+                raised.emplace_back(timeout);
+                return 0;
+            }));
+            timer.set(*onTimers.back(), timeout);
+        }
+        CHECK(timer.count() == timeouts.size());
+        Run(timer);
+        CHECK(timer.count() == 0 && timer.raise() == 0);
+        sort(timeouts.begin(), timeouts.end());
+        CHECK(raised == timeouts);
+        for (const Unique<Timer::OnTimer>& pOnTimer : onTimers)
+            CHECK(pOnTimer->count == 1 && !*pOnTimer);
+    }
+
+    // Lazy delay and advance of a timer already set
+    {
+        Timer timer;
+        int64_t start(Time::Now()), delayed(0), advanced(0);
+        Timer::OnTimer onDelayed([&](uint32_t delay) { delayed = Time::Now() - start; return 0; });
+        Timer::OnTimer onAdvanced([&](uint32_t delay) { advanced = Time::Now() - start; return 0; });
+        timer.set(onDelayed, 20);
+        timer.set(onDelayed, 100); // stays on its 20ms slot, moved on raising
+        timer.set(onAdvanced, 1000);
+        timer.set(onAdvanced, 30); // moved now
+        CHECK(timer.count() == 2);
+        Run(timer);
+        CHECK(delayed >= 100 && delayed <= 100 + Margin && onDelayed.count == 1);
+        CHECK(advanced >= 30 && advanced <= 30 + Margin && onAdvanced.count == 1);
+    }
+
+    // Re-arm, cancel, delay and set from a callback, on timers of the same tick too
+    {
+        Timer timer;
+        int64_t start(Time::Now()), late(0), added(0);
+        Timer::OnTimer onCanceled([&](uint32_t delay) { CHECK(false); return 0; });
+        Timer::OnTimer onLate([&](uint32_t delay) { late = Time::Now() - start; return 0; });
+        Timer::OnTimer onAdded([&](uint32_t delay) { added = Time::Now() - start; return 0; });
+        Timer::OnTimer onRepeat([&](uint32_t delay) { return onRepeat.count < 3 ? 10 : 0; });
+        Timer::OnTimer onFirst([&](uint32_t delay) {
+            timer.set(onCanceled, 0);
+            timer.set(onLate, 50);
+            timer.set(onAdded, 70);
+            return 0;
+        });
+        timer.set(onFirst, 40);
+        timer.set(onCanceled, 40); // same tick, pending while onFirst is raised
+        timer.set(onLate, 40);
+        timer.set(onRepeat, 10);
+        Run(timer);
+        CHECK(onFirst.count == 1 && onCanceled.count == 0 && onRepeat.count == 3);
+        CHECK(late >= 90 && late <= 90 + Margin && onLate.count == 1);
+        CHECK(added >= 110 && added <= 110 + Margin && onAdded.count == 1);
+        CHECK(timer.count() == 0);
+    }
+    return 0;
+}
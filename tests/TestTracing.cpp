@@ -0,0 +1,88 @@
+#include "Mona/Mona.h"
+#include "Mona/Threading/ThreadPool.h"
+#include "Mona/Threading/Tracing.h"
+
+using namespace std;
+using namespace Mona;
+
+static const char* Name("TestTracing");
+
+// Runner queued without thread, so stealable, which queues its children from the pool (worker deque)
+struct Job : Runner, virtual Object {
+    Job(const ThreadPool& pool, atomic<uint32_t>& ran, uint8_t children = 0) : Runner(Name), _pool(pool), _ran(ran), _children(children) {}
+    bool run(Exception& ex) {
+        for (uint8_t i = 0; i < _children; ++i)
+            _pool.queue<Job>(nullptr, _pool, _ran);
+        Thread::Sleep(1);
+        ++_ran;
+        return true;
+    }
+private:
+    const ThreadPool&   _pool;
+    atomic<uint32_t>&   _ran;
+    const uint8_t       _children;
+};
+
+static string Text(const Buffer& buffer) { return string(buffer.data(), buffer.size()); }
+
+static uint32_t Count(const string& text, const string& pattern) {
+    uint32_t count(0);
+    for (size_t found = text.find(pattern); found != string::npos; found = text.find(pattern, found + 1))
+        ++count;
+    return count;
+}
+
+int main(int argc, char** argv) {
+    // Values lower than 16 are exact, then relative precision of 1/16
+    Tracing::Histogram histogram;
+    CHECK(histogram.percentile(0.5) == 0);
+    for (uint64_t value = 1; value <= 1000; ++value)
+        histogram.record(value);
+    CHECK(histogram.count() == 1000 && histogram.sum() == 500500 && histogram.max() == 1000);
+    CHECK(histogram.percentile(0) == 1 && histogram.percentile(0.01) == 10);
+    for (double percentile : { 0.5, 0.9, 0.99, 0.999 }) {
+        uint64_t value(histogram.percentile(percentile)), expected(uint64_t(percentile * 1000 + 0.5));
+        CHECK(value >= expected && value <= expected + expected / 16);
+    }
+    CHECK(histogram.percentile(1) == 1000); // highest equivalent value bounded by max
+    Tracing::Histogram other;
+    other.record(uint64_t(1) << 40); // beyond the last bucket
+    histogram.add(other);
+    CHECK(histogram.count() == 1001 && histogram.max() == (uint64_t(1) << 40) && histogram.percentile(1) == histogram.max());
+    histogram.reset();
+    CHECK(histogram.count() == 0 && histogram.sum() == 0 && histogram.max() == 0 && histogram.percentile(0.5) == 0);
+
+    // Dump in Chrome trace format, name escaped and wait written only if known
+    Tracing::Reset();
+    Buffer buffer;
+    CHECK(Text(Tracing::Dump(buffer)) == "{\"traceEvents\":[\n],\"displayTimeUnit\":\"ms\"}\n");
+    static const char* Quoted("quoted \"name\"");
+    Tracing::Record(Quoted, 0, 10, 25);
+    Tracing::Record(Quoted, 4, 10, 20);
+    string dump(Text(Tracing::Dump(buffer.clear())));
+    CHECK(dump.find("{\"name\":\"quoted \\\"name\\\"\",\"cat\":\"runner\",\"ph\":\"X\",\"pid\":0,\"tid\":") != string::npos);
+    CHECK(dump.find(",\"ts\":10,\"dur\":15}") != string::npos && dump.find(",\"ts\":10,\"dur\":10,\"args\":{\"wait\":6}}") != string::npos);
+
+    // Stealing pool: runners injected out of pool and pushed in worker deques have their wait recorded
+    Tracing::Record(Name, 1, 1, 1); // creates the histograms of Name, else events are ignored while a concurrent thread creates them
+    Tracing::Enable();
+    {
+        ThreadPool pool(ThreadPool::MODE_STEALING, 2);
+        atomic<uint32_t> ran(0);
+        for (uint8_t i = 0; i < 8; ++i)
+            pool.queue<Job>(nullptr, pool, ran, 8);
+        while (ran < 72)
+            Thread::Sleep(1);
+    }
+    Tracing::Enable(false);
+    dump = Text(Tracing::Dump(buffer.clear()));
+    CHECK(Count(dump, "{\"name\":\"TestTracing\"") == 73 && Count(dump, "\"args\":{\"wait\":") == 74);
+
+    Metrics::Writer writer(buffer.clear());
+    Tracing::Collect(writer);
+    string metrics(Text(buffer));
+    CHECK(metrics.find("mona_runner_wait_microseconds_count{runner=\"TestTracing\"} 73\n") != string::npos);
+    CHECK(metrics.find("mona_runner_run_microseconds_count{runner=\"TestTracing\"} 73\n") != string::npos);
+    CHECK(metrics.find("mona_runner_wait_microseconds_count{runner=\"quoted \\\"name\\\"\"} 1\n") != string::npos);
+    return 0;
+}